@@ -0,0 +1,241 @@
+#include "engine.h"
+#include "journal.h"
+#include "trace.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <random>
+
+static void record(ChangeJournal* journal, ChangeType type, const Position& pos = Position(), int value = 0) {
+    if (journal) journal->record(type, pos, value);
+}
+
+GameEngine::GameEngine(const Level& level, uint64_t seed)
+    : level(level),
+      rng(seed),
+      snake(std::deque<Position>(1, level.getSpawn(0)), level.getSpawnDirection(0), level.getWidth(), level.getHeight()),
+      food(level.getSpawn(0)),
+      score(0),
+      specialFoodActive(false),
+      specialFoodTimer(0),
+      specialFoodCount(0),
+      foodSpawnAttempts(0) {
+    // No draws until reset(), so the first game is the first draw on the RNG
+    // whichever level it is played on. Until then the food sits on the first
+    // free cell the snake isn't on
+    const std::vector<Position>& cells = level.getFreeCells();
+    auto clear = std::find_if(cells.begin(), cells.end(),
+                              [&](const Position& p) { return !snake.isOnPosition(p.x, p.y); });
+    if (clear != cells.end()) food = *clear;
+}
+
+void GameEngine::reset() {
+    // Snake at one of the level's spawn points, then food, then (on the
+    // built-in board only) 5-7 random obstacles
+    int spawn = 0;
+    if (level.getSpawnCount() > 1) {
+        std::uniform_int_distribution<int> pick(0, level.getSpawnCount() - 1);
+        spawn = pick(rng);
+    }
+    std::deque<Position> body(1, level.getSpawn(spawn));
+    snake = Snake(body, level.getSpawnDirection(spawn), level.getWidth(), level.getHeight());
+    score = 0;
+    specialFoodCount = 0;
+    specialFoodActive = false;
+    specialFoodTimer = 0;
+    obstacles.clear();
+    generateFood();
+    if (level.isBuiltIn()) {
+        std::uniform_int_distribution<int> obc(5, 7);
+        generateObstacles(obc(rng));
+    }
+}
+
+bool GameEngine::isFoodCell(const Position& p, const Position* taken) const {
+    // Walls and exclusion zones are already left out of the free-cell list
+    return !snake.isOnPosition(p.x, p.y) && !(taken && p == *taken) &&
+           std::find(obstacles.begin(), obstacles.end(), p) == obstacles.end();
+}
+
+bool GameEngine::pickFoodCell(Position& out, const Position* taken) {
+    // Random cells are tried first, which is quick while the board is mostly
+    // empty; after as many misses as there are cells, pick among the cells
+    // that are actually left so a nearly full board neither spins nor
+    // settles on an occupied cell
+    const std::vector<Position>& cells = level.getFreeCells();
+    std::uniform_int_distribution<size_t> pick(0, cells.size() - 1);
+    for (size_t attempt = 0; attempt < cells.size(); ++attempt) {
+        out = cells[pick(rng)];
+        foodSpawnAttempts++;
+        if (isFoodCell(out, taken)) return true;
+    }
+    std::vector<Position> left;
+    for (const auto& cell : cells) {
+        if (isFoodCell(cell, taken)) left.push_back(cell);
+    }
+    if (left.empty()) return false;
+    std::uniform_int_distribution<size_t> pickLeft(0, left.size() - 1);
+    out = left[pickLeft(rng)];
+    return true;
+}
+
+bool GameEngine::generateFood() {
+    TRACE_SCOPE("GameEngine::generateFood");
+    return pickFoodCell(food, nullptr);
+}
+
+void GameEngine::generateSpecialFood() {
+    TRACE_SCOPE("GameEngine::generateSpecialFood");
+    // Only generate special food if it's not already active, and only where
+    // there is room for it
+    if (!specialFoodActive && pickFoodCell(specialFood, &food)) {
+        specialFoodActive = true;
+        specialFoodTimer = SPECIAL_FOOD_MAX_TIMER;
+    }
+}
+
+void GameEngine::generateObstacles(int count) {
+    obstacles.clear();
+    std::uniform_int_distribution<int> distX(0, level.getWidth() - 1);
+    std::uniform_int_distribution<int> distY(0, level.getHeight() - 1);
+    int attempts = 0;
+    while ((int)obstacles.size() < count && attempts < count * 20) {
+        // Drawn in two statements: argument evaluation order is unspecified
+        int x = distX(rng);
+        int y = distY(rng);
+        Position p(x, y);
+        attempts++;
+        if (snake.isOnPosition(p.x, p.y) || level.isWall(p)) continue;
+        if (p == food || (specialFoodActive && p == specialFood)) continue;
+        if (std::find(obstacles.begin(), obstacles.end(), p) != obstacles.end()) continue;
+        obstacles.push_back(p);
+    }
+}
+
+TickResult GameEngine::tick(ChangeJournal* journal) {
+    int oldLength = snake.getLength();
+
+    if (!snake.move(journal)) return TICK_DIED;
+    // Wall and obstacle collision
+    if (level.isWall(snake.getHead()) ||
+        std::find(obstacles.begin(), obstacles.end(), snake.getHead()) != obstacles.end()) {
+        return TICK_DIED;
+    }
+
+    // Check if snake ate regular food
+    if (snake.getHead() == food) {
+        snake.grow();
+        score += 10;
+        if (!generateFood()) {
+            // The snake fills every cell food could go to: nothing left to play for
+            record(journal, CHANGE_SCORE, Position(), score);
+            return TICK_CLEARED;
+        }
+        record(journal, CHANGE_FOOD_SPAWNED, food);
+        record(journal, CHANGE_SCORE, Position(), score);
+
+        // Check if we should spawn special food (every 30 points)
+        if (score % 30 == 0 && score > 0 && !specialFoodActive) {
+            generateSpecialFood();
+            if (specialFoodActive) record(journal, CHANGE_SPECIAL_SPAWNED, specialFood, specialFoodTimer);
+        }
+    }
+
+    // Check if snake ate special food; it is worth two extra segments
+    if (specialFoodActive && snake.getHead() == specialFood) {
+        snake.grow();
+        score += SPECIAL_FOOD_POINTS;
+        specialFoodActive = false;
+        specialFoodTimer = 0;
+        specialFoodCount++;
+        record(journal, CHANGE_SPECIAL_CLEARED, specialFood);
+        record(journal, CHANGE_SCORE, Position(), score);
+        record(journal, CHANGE_RARE_COUNT, Position(), specialFoodCount);
+        snake.grow();
+    }
+
+    // Update special food timer
+    if (specialFoodActive) {
+        specialFoodTimer--;
+        record(journal, CHANGE_SPECIAL_TIMER, Position(), specialFoodTimer);
+        if (specialFoodTimer <= 0) {
+            specialFoodActive = false; // Special food disappears
+            specialFoodTimer = 0;
+            record(journal, CHANGE_SPECIAL_CLEARED, specialFood);
+        }
+    }
+
+    if (snake.getLength() != oldLength) {
+        record(journal, CHANGE_LENGTH, Position(), snake.getLength());
+    }
+    return TICK_ALIVE;
+}
+
+bool GameEngine::snapshot(CompactGameState& out) const {
+    if (snake.getLength() > COMPACT_MAX_LENGTH || obstacles.size() > COMPACT_MAX_OBSTACLES) return false;
+    // Padding included, so equal states compare equal with memcmp; the RNG
+    // member makes the struct non-trivial to construct, not to copy
+    std::memset(static_cast<void*>(&out), 0, sizeof(out));
+    out.width = static_cast<uint8_t>(level.getWidth());
+    out.height = static_cast<uint8_t>(level.getHeight());
+    out.levelChecksum = level.getChecksum();
+    out.direction = static_cast<uint8_t>(snake.getDirection());
+    out.score = score;
+    out.specialFoodCount = specialFoodCount;
+    out.specialFoodTimer = static_cast<int16_t>(specialFoodTimer);
+    out.specialFoodActive = specialFoodActive ? 1 : 0;
+    out.food = packPos(food);
+    out.specialFood = packPos(specialFood);
+#ifdef SNAKE_RNG_COMPACT
+    out.rng = rng;
+#endif
+    for (const auto& ob : obstacles) {
+        out.obstacles[out.obstacleCount++] = packPos(ob);
+    }
+    for (const auto& segment : snake.getBody()) {
+        out.body[out.length++] = packPos(segment);
+    }
+    return true;
+}
+
+bool GameEngine::restore(const CompactGameState& in, const Level& onLevel) {
+    // Snapshots may come from storage: reject anything this game couldn't
+    // have produced before touching the current state
+    if (in.levelChecksum != onLevel.getChecksum() ||
+        in.width != onLevel.getWidth() || in.height != onLevel.getHeight()) {
+        return false;
+    }
+    if (in.length == 0 || in.length > COMPACT_MAX_LENGTH || in.obstacleCount > COMPACT_MAX_OBSTACLES ||
+        in.direction > RIGHT || in.score < 0 || in.specialFoodCount < 0 ||
+        in.specialFoodTimer < 0 || in.specialFoodTimer > SPECIAL_FOOD_MAX_TIMER || in.specialFoodActive > 1) {
+        return false;
+    }
+    auto onBoard = [&in](PackedPos cell) {
+        Position p = unpackPos(cell);
+        return p.x < in.width && p.y < in.height;
+    };
+    if (!onBoard(in.food) || (in.specialFoodActive && !onBoard(in.specialFood))) return false;
+    for (int i = 0; i < in.length; ++i) {
+        if (!onBoard(in.body[i])) return false;
+    }
+    for (int i = 0; i < in.obstacleCount; ++i) {
+        if (!onBoard(in.obstacles[i])) return false;
+    }
+
+    level = onLevel;
+    std::deque<Position> body;
+    for (int i = 0; i < in.length; ++i) body.push_back(in.segment(i));
+    snake = Snake(body, static_cast<Direction>(in.direction), in.width, in.height);
+    score = in.score;
+    specialFoodCount = in.specialFoodCount;
+    specialFoodTimer = in.specialFoodTimer;
+    specialFoodActive = in.specialFoodActive != 0;
+    food = unpackPos(in.food);
+    specialFood = unpackPos(in.specialFood);
+#ifdef SNAKE_RNG_COMPACT
+    rng = in.rng;
+#endif
+    obstacles.clear();
+    for (int i = 0; i < in.obstacleCount; ++i) obstacles.push_back(unpackPos(in.obstacles[i]));
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "snake.h"
+#include "level.h"
+#include "rng.h"
+#include "game_state.h"
+#include <cstdint>
+#include <vector>
+
+class ChangeJournal;
+
+// How a tick ended
+enum TickResult {
+    TICK_ALIVE,
+    TICK_DIED,    // off the board, into itself, a wall or an obstacle
+    TICK_CLEARED  // the snake covers every cell food could go to
+};
+
+// The rules of one game: board, snake, food, score and the RNG that places
+// things, with no terminal, input or files. Game drives one per session;
+// tools can step it headless.
+class GameEngine {
+public:
+    static const int SPECIAL_FOOD_POINTS = 30;
+    static const int SPECIAL_FOOD_MAX_TIMER = 50;
+
+private:
+    Level level;
+    GameRng rng;
+    Snake snake;
+    Position food;
+    Position specialFood;
+    std::vector<Position> obstacles;
+    int score;
+    bool specialFoodActive;
+    int specialFoodTimer;
+    int specialFoodCount;
+    uint64_t foodSpawnAttempts;
+
+    bool isFoodCell(const Position& p, const Position* taken) const;
+    bool pickFoodCell(Position& out, const Position* taken);
+    bool generateFood(); // false when no cell is left for food
+    void generateSpecialFood();
+    void generateObstacles(int count);
+
+public:
+    // Seeds the RNG and puts the snake on the first spawn point without
+    // drawing from it; call reset() before playing
+    GameEngine(const Level& level, uint64_t seed);
+
+    // New snake, food and obstacles on the current level; the score starts over
+    void reset();
+    // Plays on another level from the next reset()
+    void setLevel(const Level& newLevel) { level = newLevel; }
+
+    void changeDirection(Direction direction) { snake.changeDirection(direction); }
+    // One move with everything it triggers; changes go to the journal if given
+    TickResult tick(ChangeJournal* journal = nullptr);
+
+    // snapshot() fails when the snake or the obstacles don't fit the compact
+    // arrays. restore() fails, leaving the game as it was, when the snapshot
+    // wasn't taken on the given level or has fields out of range (empty or
+    // oversized snake, bad direction or timer, cells off the board). The game
+    // state byte is left to the caller.
+    bool snapshot(CompactGameState& out) const;
+    bool restore(const CompactGameState& in, const Level& onLevel);
+    // The RNG that places food and obstacles; snapshots carry it only with
+    // SNAKE_RNG_COMPACT, otherwise save it alongside to resume the same game
+    const GameRng& getRng() const { return rng; }
+    void setRng(const GameRng& state) { rng = state; }
+
+    const Level& getLevel() const { return level; }
+    const Snake& getSnake() const { return snake; }
+    const Position& getFood() const { return food; }
+    const Position& getSpecialFood() const { return specialFood; }
+    bool isSpecialFoodActive() const { return specialFoodActive; }
+    int getSpecialFoodTimer() const { return specialFoodTimer; }
+    const std::vector<Position>& getObstacles() const { return obstacles; }
+    int getScore() const { return score; }
+    int getSpecialFoodCount() const { return specialFoodCount; }
+    uint64_t getFoodSpawnAttempts() const { return foodSpawnAttempts; }
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include "event_loop.h"
+#include "utils.h"
+
+#if defined(__linux__)
+    #include <sys/epoll.h>
+    #include <sys/timerfd.h>
+    #include <sys/signalfd.h>
+    #include <signal.h>
+    #include <unistd.h>
+    #include <cstdint>
+    #include <cerrno>
+#elif !defined(_WIN32)
+    #include <poll.h>
+    #include <signal.h>
+    #include <cerrno>
+#endif
+
+#if !defined(__linux__) && !defined(_WIN32)
+static volatile sig_atomic_t pendingResize = 0;
+static volatile sig_atomic_t pendingTerminate = 0;
+
+static void onLoopSignal(int sig) {
+    if (sig == SIGWINCH) pendingResize = 1;
+    else pendingTerminate = 1;
+}
+#endif
+
+EventLoop::EventLoop()
+    : epollFd(-1), timerFd(-1), signalFd(-1), tickIntervalMs(0),
+      nextTick(std::chrono::steady_clock::now()) {
+#if defined(__linux__)
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+    // Deliver the signals we care about through an fd instead of handlers
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGWINCH);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGHUP);
+    sigprocmask(SIG_BLOCK, &mask, nullptr);
+    signalFd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = STDIN_FILENO;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, STDIN_FILENO, &ev);
+    ev.data.fd = timerFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &ev);
+    ev.data.fd = signalFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, signalFd, &ev);
+#elif !defined(_WIN32)
+    signal(SIGWINCH, onLoopSignal);
+    signal(SIGTERM, onLoopSignal);
+    signal(SIGINT, onLoopSignal);
+    signal(SIGHUP, onLoopSignal);
+#endif
+}
+
+EventLoop::~EventLoop() {
+#if defined(__linux__)
+    if (signalFd >= 0) close(signalFd);
+    if (timerFd >= 0) close(timerFd);
+    if (epollFd >= 0) close(epollFd);
+#endif
+}
+
+void EventLoop::setTickInterval(int intervalMs) {
+    if (intervalMs == tickIntervalMs) return;
+    tickIntervalMs = intervalMs;
+#if defined(__linux__)
+    itimerspec spec = {};
+    if (intervalMs > 0) {
+        spec.it_interval.tv_sec = intervalMs / 1000;
+        spec.it_interval.tv_nsec = (intervalMs % 1000) * 1000000L;
+        spec.it_value = spec.it_interval;
+    }
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+#endif
+    nextTick = std::chrono::steady_clock::now() + std::chrono::milliseconds(intervalMs);
+}
+
+void EventLoop::watchFd(int fd) {
+    if (fd < 0) return;
+    watched.push_back(fd);
+#if defined(__linux__)
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+#endif
+}
+
+#if defined(__linux__)
+
+int EventLoop::wait() {
+    epoll_event events[8];
+    int n;
+    do {
+        n = epoll_wait(epollFd, events, 8, -1);
+    } while (n < 0 && errno == EINTR);
+
+    int result = 0;
+    for (int i = 0; i < n; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == STDIN_FILENO) {
+            result |= EVENT_INPUT;
+        } else if (fd == timerFd) {
+            // Overruns collapse into a single tick; the game never fast-forwards
+            uint64_t expirations;
+            if (read(timerFd, &expirations, sizeof(expirations)) > 0 && tickIntervalMs > 0) {
+                result |= EVENT_TICK;
+            }
+        } else if (fd == signalFd) {
+            signalfd_siginfo info;
+            while (read(signalFd, &info, sizeof(info)) == sizeof(info)) {
+                result |= (info.ssi_signo == SIGWINCH) ? EVENT_RESIZE : EVENT_TERMINATE;
+            }
+        } else {
+            result |= EVENT_WATCHED;
+        }
+    }
+    return result;
+}
+
+#elif !defined(_WIN32)
+
+int EventLoop::wait() {
+    std::vector<pollfd> fds;
+    pollfd in = { STDIN_FILENO, POLLIN, 0 };
+    fds.push_back(in);
+    for (int fd : watched) {
+        pollfd w = { fd, POLLIN, 0 };
+        fds.push_back(w);
+    }
+
+    while (true) {
+        int result = 0;
+        if (pendingResize) { pendingResize = 0; result |= EVENT_RESIZE; }
+        if (pendingTerminate) { pendingTerminate = 0; result |= EVENT_TERMINATE; }
+
+        int timeoutMs = -1;
+        auto now = std::chrono::steady_clock::now();
+        if (tickIntervalMs > 0) {
+            if (now >= nextTick) {
+                nextTick = now + std::chrono::milliseconds(tickIntervalMs);
+                result |= EVENT_TICK;
+            } else {
+                timeoutMs = static_cast<int>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(nextTick - now).count()) + 1;
+            }
+        }
+        if (result) timeoutMs = 0;
+
+        int n = poll(fds.data(), fds.size(), timeoutMs);
+        if (n > 0) {
+            if (fds[0].revents) result |= EVENT_INPUT;
+            for (size_t i = 1; i < fds.size(); ++i) {
+                if (fds[i].revents) result |= EVENT_WATCHED;
+            }
+        }
+        if (result) return result;
+    }
+}
+
+#else
+
+int EventLoop::wait() {
+    HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+    while (true) {
+        int result = 0;
+        DWORD timeoutMs = INFINITE;
+        auto now = std::chrono::steady_clock::now();
+        if (tickIntervalMs > 0) {
+            if (now >= nextTick) {
+                nextTick = now + std::chrono::milliseconds(tickIntervalMs);
+                result |= EVENT_TICK;
+            } else {
+                timeoutMs = static_cast<DWORD>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(nextTick - now).count()) + 1;
+            }
+        }
+        if (_kbhit()) result |= EVENT_INPUT;
+        if (result) return result;
+
+        // The console handle is signalled for any input record; mouse and
+        // focus events simply loop back to the _kbhit() check
+        if (WaitForSingleObject(input, timeoutMs) == WAIT_OBJECT_0 && !_kbhit()) {
+            INPUT_RECORD record;
+            DWORD count = 0;
+            ReadConsoleInput(input, &record, 1, &count);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+#include <chrono>
+#include <vector>
+
+// Bit flags returned by EventLoop::wait()
+enum LoopEvent {
+    EVENT_INPUT = 1,      // stdin has bytes to read
+    EVENT_TICK = 2,       // a game tick deadline passed
+    EVENT_RESIZE = 4,     // terminal was resized (SIGWINCH)
+    EVENT_TERMINATE = 8,  // SIGTERM/SIGINT/SIGHUP received
+    EVENT_WATCHED = 16    // one of the fds passed to watchFd() is readable
+};
+
+// Blocks until there is something to do. On Linux this is an epoll reactor
+// over stdin, a timerfd for ticks and a signalfd; with ticks disabled an idle
+// game makes no wakeups at all. Other platforms fall back to poll() or a
+// console handle wait with the same semantics.
+class EventLoop {
+private:
+    int epollFd;
+    int timerFd;
+    int signalFd;
+    int tickIntervalMs;
+    std::vector<int> watched;
+    std::chrono::steady_clock::time_point nextTick; // fallback timer
+
+public:
+    EventLoop();
+    ~EventLoop();
+
+    // Start periodic ticks every intervalMs milliseconds; 0 stops them
+    void setTickInterval(int intervalMs);
+    int getTickInterval() const { return tickIntervalMs; }
+
+    void watchFd(int fd);
+
+    // Wait for the next batch of events; returns a mask of LoopEvent
+    int wait();
+};
+
+#endif
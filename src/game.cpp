@@ -1,117 +1,76 @@
 #include "game.h"
 #include "utils.h"
+#include "trace.h"
 #include <iostream>
-#include <random>
 #include <fstream>
-#include <algorithm>
-#include <limits>
 #include <string>
-#include <cstdlib>
 
-Game::Game() 
-    : snake(BOARD_WIDTH / 2, BOARD_HEIGHT / 2, BOARD_WIDTH, BOARD_HEIGHT),
-      renderer(BOARD_WIDTH, BOARD_HEIGHT),
-      score(0), highScore(0), state(MENU),
-      frameController(10),
-      specialFoodActive(false),
-      specialFoodTimer(0),
-      specialFoodPoints(30),
-      specialFoodMaxTimer(50),
-      rng(std::random_device{}()),
+Game::Game(RenderMode renderMode, uint64_t seed) 
+    : renderer(DEFAULT_BOARD_WIDTH, DEFAULT_BOARD_HEIGHT, renderMode),
+      highScore(0), state(MENU),
+      frameController(4), // 250 ms per tick: the former 100 ms frame plus 150 ms sleep
       playerName(""),
       highScoreName(""),
-      specialFoodCount(0) {
+      running(false),
+      menuScreen(MENU_MAIN),
+      counters(),
+      levels(1, Level(DEFAULT_BOARD_WIDTH, DEFAULT_BOARD_HEIGHT)),
+      currentLevel(0),
+      engine(levels[0], seed) {
+    journal.subscribe(&renderer);
+    journal.subscribe(&spectator);
     loadHighScore();
-    generateFood();
-    // Place 5-7 obstacles
-    {
-        std::uniform_int_distribution<int> obc(5, 7);
-        generateObstacles(obc(rng));
-    }
 }
 
-void Game::generateFood() {
-    do {
-        std::uniform_int_distribution<int> distX(0, BOARD_WIDTH - 1);
-        std::uniform_int_distribution<int> distY(0, BOARD_HEIGHT - 1);
-        food = Position(distX(rng), distY(rng));
-    } while (snake.isOnPosition(food.x, food.y) ||
-             std::find(obstacles.begin(), obstacles.end(), food) != obstacles.end());
+bool Game::loadLevel(const std::string& path) {
+    Level loaded;
+    if (!loaded.load(path)) return false;
+    if (levels.size() == 1 && levels[0].isBuiltIn()) {
+        levels[0] = loaded;
+        switchLevel(0);
+    } else {
+        levels.push_back(loaded);
+    }
+    return true;
 }
 
-void Game::generateSpecialFood() {
-    // Only generate special food if it's not already active
-    if (!specialFoodActive) {
-        int attempts = 0;
-        do {
-            std::uniform_int_distribution<int> distX(0, BOARD_WIDTH - 1);
-            std::uniform_int_distribution<int> distY(0, BOARD_HEIGHT - 1);
-            specialFood = Position(distX(rng), distY(rng));
-            attempts++;
-            
-            // Prevent infinite loop
-            if (attempts > BOARD_WIDTH * BOARD_HEIGHT) {
-                break;
-            }
-        } while (snake.isOnPosition(specialFood.x, specialFood.y) || 
-                (specialFood.x == food.x && specialFood.y == food.y) ||
-                std::find(obstacles.begin(), obstacles.end(), specialFood) != obstacles.end());
-        
-        specialFoodActive = true;
-        specialFoodTimer = specialFoodMaxTimer; // 5 seconds at ~10 FPS
-    }
+void Game::switchLevel(size_t index) {
+    currentLevel = index;
+    engine.setLevel(level());
+    renderer.setBoard(level().getWidth(), level().getHeight(), level().getWalls());
 }
 
-void Game::generateObstacles(int count) {
-    obstacles.clear();
-    std::uniform_int_distribution<int> distX(0, BOARD_WIDTH - 1);
-    std::uniform_int_distribution<int> distY(0, BOARD_HEIGHT - 1);
-    int attempts = 0;
-    while ((int)obstacles.size() < count && attempts < count * 20) {
-        Position p(distX(rng), distY(rng));
-        attempts++;
-        if (snake.isOnPosition(p.x, p.y)) continue;
-        if (p == food || (specialFoodActive && p == specialFood)) continue;
-        if (std::find(obstacles.begin(), obstacles.end(), p) != obstacles.end()) continue;
-        obstacles.push_back(p);
-    }
+int Game::nextKey() {
+    if (pendingKeys.empty()) return -1;
+    int key = pendingKeys.front();
+    pendingKeys.pop_front();
+    return key;
 }
 
 void Game::handleInput() {
-    if (!kbhit()) return;
+    if (pendingKeys.empty()) return;
+    TRACE_SCOPE("Game::handleInput");
     
-    int key = getch();
+    int key = nextKey();
     
-    // Menu input
     if (state == MENU) {
-        if (key == '1') {
-            askPlayerName();
-            resetGame();
-            state = PLAYING;
-        } else if (key == '2') {
-            renderer.renderHighScore(highScoreName, highScore);
-            (void)getch();
-            renderer.renderMenu();
-        } else if (key == '3' || key == 'q' || key == 'Q') {
-            saveHighScore();
-            std::exit(0);
-        }
+        handleMenuKey(key);
         return;
     }
     
     // Handle escape sequences for arrow keys (Linux/macOS)
     if (key == 27) {
-        if (!kbhit()) return;
-        int key2 = getch();
+        if (pendingKeys.empty()) return;
+        int key2 = nextKey();
         if (key2 == 91) {
-            if (!kbhit()) return;
-            int key3 = getch();
+            if (pendingKeys.empty()) return;
+            int key3 = nextKey();
             if (state == PLAYING) {
                 switch (key3) {
-                    case 65: snake.changeDirection(UP); break;
-                    case 66: snake.changeDirection(DOWN); break;
-                    case 67: snake.changeDirection(RIGHT); break;
-                    case 68: snake.changeDirection(LEFT); break;
+                    case 65: engine.changeDirection(UP); break;
+                    case 66: engine.changeDirection(DOWN); break;
+                    case 67: engine.changeDirection(RIGHT); break;
+                    case 68: engine.changeDirection(LEFT); break;
                 }
             }
         }
@@ -120,22 +79,29 @@ void Game::handleInput() {
     
     // Handle regular keys
     if (key == 'w' || key == 'W' || key == 72) {
-        if (state == PLAYING) snake.changeDirection(UP);
+        if (state == PLAYING) engine.changeDirection(UP);
     }
     else if (key == 's' || key == 'S' || key == 80) {
-        if (state == PLAYING) snake.changeDirection(DOWN);
+        if (state == PLAYING) engine.changeDirection(DOWN);
     }
     else if (key == 'a' || key == 'A' || key == 75) {
-        if (state == PLAYING) snake.changeDirection(LEFT);
+        if (state == PLAYING) engine.changeDirection(LEFT);
     }
     else if (key == 'd' || key == 'D' || key == 77) {
-        if (state == PLAYING) snake.changeDirection(RIGHT);
+        if (state == PLAYING) engine.changeDirection(RIGHT);
     }
     else if (key == 'p' || key == 'P') {
         if (state == PLAYING || state == PAUSED) {
             state = (state == PLAYING) ? PAUSED : PLAYING;
         }
     }
+    else if (key == 'n' || key == 'N') {
+        // Next level; every layer is precomputed, so this is just a new game on it
+        if ((state == PLAYING || state == PAUSED) && levels.size() > 1) {
+            switchLevel((currentLevel + 1) % levels.size());
+            resetGame();
+        }
+    }
     else if (key == ' ' || key == 'r' || key == 'R') {
         if (state == GAME_OVER) {
             state = MENU;
@@ -147,88 +113,104 @@ void Game::handleInput() {
     else if (key == 'q' || key == 'Q') {
         saveHighScore();
         state = GAME_OVER;
-        std::exit(0);
+        running = false;
     }
 }
 
 void Game::update() {
     if (state != PLAYING) return;
+    TRACE_SCOPE("Game::update");
     
-    if (!snake.move()) {
-        state = GAME_OVER;
-        if (score > highScore) {
-            highScore = score;
-            highScoreName = playerName;
-            saveHighScore();
-        }
-        saveScoreEntry();
-        return;
-    }
-    // Obstacle collision
-    if (std::find(obstacles.begin(), obstacles.end(), snake.getHead()) != obstacles.end()) {
-        state = GAME_OVER;
-        if (score > highScore) {
-            highScore = score;
-            highScoreName = playerName;
-            saveHighScore();
-        }
-        saveScoreEntry();
+    int rareFoods = engine.getSpecialFoodCount();
+    if (engine.tick(&journal) != TICK_ALIVE) {
+        endGame();
         return;
     }
     
-    // Check if snake ate regular food
-    if (snake.getHead().x == food.x && snake.getHead().y == food.y) {
-        snake.grow();
-        score += 10;
-        generateFood();
-        
-        // Check if we should spawn special food (every 30 points)
-        if (score % 30 == 0 && score > 0) {
-            generateSpecialFood();
-        }
+    // Eating special food updates the high score mid-game; endGame() covers the rest
+    if (engine.getSpecialFoodCount() != rareFoods && engine.getScore() > highScore) {
+        highScore = engine.getScore();
+        highScoreName = playerName;
+        journal.record(CHANGE_HIGH_SCORE, highScore);
     }
-    
-    // Check if snake ate special food
-    if (specialFoodActive && 
-        snake.getHead().x == specialFood.x && snake.getHead().y == specialFood.y) {
-        snake.grow();
-        score += specialFoodPoints;
-        specialFoodActive = false;
-        specialFoodTimer = 0;
-        specialFoodCount++;
-        
-        // Add bonus growth for special food
-        snake.grow(); // Extra segment for special food
-        
-        // Update high score if needed
-        if (score > highScore) {
-            highScore = score;
-            highScoreName = playerName;
-        }
-    }
-    
-    // Update special food timer
-    if (specialFoodActive) {
-        specialFoodTimer--;
-        if (specialFoodTimer <= 0) {
-            specialFoodActive = false; // Special food disappears
-            specialFoodTimer = 0;
-        }
+}
+
+void Game::endGame() {
+    state = GAME_OVER;
+    journal.record(CHANGE_GAME_OVER);
+    if (engine.getScore() > highScore) {
+        highScore = engine.getScore();
+        highScoreName = playerName;
+        saveHighScore();
     }
+    saveScoreEntry();
 }
 
 void Game::resetGame() {
-    snake = Snake(BOARD_WIDTH / 2, BOARD_HEIGHT / 2, BOARD_WIDTH, BOARD_HEIGHT);
-    score = 0;
-    specialFoodCount = 0;
     state = PLAYING;
-    specialFoodActive = false;
-    specialFoodTimer = 0;
-    generateFood();
-    {
-        std::uniform_int_distribution<int> obc(5, 7);
-        generateObstacles(obc(rng));
+    engine.reset();
+    // Every cell may have changed; resynchronise all consumers
+    journal.record(CHANGE_RESET);
+    publishKeyframe(true);
+}
+
+bool Game::snapshot(CompactGameState& out) const {
+    if (!engine.snapshot(out)) return false;
+    out.state = static_cast<uint8_t>(state);
+    return true;
+}
+
+bool Game::restore(const CompactGameState& in) {
+    // Find the board the snapshot was taken on
+    size_t index = 0;
+    while (index < levels.size() &&
+           !(levels[index].getChecksum() == in.levelChecksum &&
+             levels[index].getWidth() == in.width && levels[index].getHeight() == in.height)) {
+        ++index;
     }
+    if (index == levels.size() || in.state > GAME_OVER) return false;
+    if (!engine.restore(in, levels[index])) return false;
+    if (index != currentLevel) {
+        currentLevel = index;
+        renderer.setBoard(level().getWidth(), level().getHeight(), level().getWalls());
+    }
+    state = static_cast<GameState>(in.state);
+    
+    journal.record(CHANGE_RESET);
+    publishKeyframe(true);
+    return true;
+}
+
+bool Game::enableMetrics(const std::string& shmName) {
+    return metrics.open(shmName);
+}
+
+void Game::publishMetrics() {
+    if (!metrics.isOpen()) return;
+    counters.framesRendered = renderer.getFramesRendered();
+    counters.foodSpawnAttempts = engine.getFoodSpawnAttempts();
+    counters.bytesWritten = metrics.getTerminalBytes();
+    // No ticks run outside play; the last playing rate would read as active
+    counters.fps = state == PLAYING ? static_cast<uint32_t>(frameController.getFPS()) : 0;
+    counters.state = static_cast<uint32_t>(state);
+    metrics.publish(counters);
+}
+
+bool Game::enableSpectatorFeed(const std::string& socketPath) {
+    return spectator.open(socketPath);
+}
+
+void Game::publishKeyframe(bool toAll) {
+    if (!spectator.isOpen()) return;
+    spectator.sendKeyframe(level().getWidth(), level().getHeight(), engine.getSnake(), engine.getFood(),
+                           engine.getSpecialFood(), engine.isSpecialFoodActive(), level().getWalls(),
+                           engine.getObstacles(), engine.getScore(), toAll);
+}
+
+void Game::renderBoard(bool paused) {
+    renderer.render(engine.getSnake(), engine.getFood(), engine.getSpecialFood(), engine.isSpecialFoodActive(),
+                    engine.getSpecialFoodTimer(), GameEngine::SPECIAL_FOOD_MAX_TIMER, engine.getScore(), highScore,
+                    paused, engine.getObstacles(), engine.getSpecialFoodCount());
 }
 
 void Game::saveHighScore() {
@@ -272,64 +254,152 @@ void Game::loadHighScore() {
     }
 }
 
-void Game::askPlayerName() {
-    clearScreen();
-    std::cout << "Enter your name: ";
-    std::cout.flush();
-    if (std::cin.peek() == '\n') std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-    std::getline(std::cin, playerName);
-    if (playerName.empty()) playerName = "Player";
+void Game::handleMenuKey(int key) {
+    switch (menuScreen) {
+        case MENU_MAIN:
+            if (key == '1') {
+                nameInput.clear();
+                menuScreen = MENU_NAME_ENTRY;
+                renderer.renderNamePrompt(nameInput);
+            } else if (key == '2') {
+                menuScreen = MENU_HIGH_SCORE;
+                renderer.renderHighScore(highScoreName, highScore);
+            } else if (key == '3' || key == 'q' || key == 'Q') {
+                saveHighScore();
+                running = false;
+            }
+            break;
+        case MENU_HIGH_SCORE:
+            // Any key returns from the high score screen
+            menuScreen = MENU_MAIN;
+            renderer.renderMenu();
+            break;
+        case MENU_NAME_ENTRY:
+            handleNameKey(key);
+            break;
+    }
+}
+
+void Game::handleNameKey(int key) {
+    // One key at a time from the event loop, echoed in place on the prompt
+    if (key == '\n' || key == '\r') {
+        playerName = nameInput.empty() ? std::string("Player") : nameInput;
+        menuScreen = MENU_MAIN;
+        resetGame();
+        state = PLAYING;
+    } else if (key == 127 || key == 8) {
+        if (!nameInput.empty()) {
+            nameInput.erase(nameInput.size() - 1);
+            renderer.eraseNameChar();
+        }
+    } else if (key >= 32 && key < 127 && nameInput.size() < 24) {
+        nameInput += static_cast<char>(key);
+        renderer.echoNameChar(static_cast<char>(key));
+    }
 }
 
 void Game::saveScoreEntry() {
     std::ofstream log("scores.txt", std::ios::app);
     if (log.is_open()) {
-        log << (playerName.empty() ? std::string("Player") : playerName) << "," << score << "\n";
+        log << (playerName.empty() ? std::string("Player") : playerName) << "," << engine.getScore() << "\n";
         log.close();
     }
 }
 
+void Game::redrawScreen() {
+    renderer.invalidate();
+    switch (state) {
+        case MENU:
+            if (menuScreen == MENU_HIGH_SCORE) renderer.renderHighScore(highScoreName, highScore);
+            else if (menuScreen == MENU_NAME_ENTRY) renderer.renderNamePrompt(nameInput);
+            else renderer.renderMenu();
+            break;
+        case PLAYING:
+        case PAUSED:
+            renderBoard(state == PAUSED);
+            break;
+        case GAME_OVER:
+            renderer.renderGameOver(engine.getScore(), highScore);
+            break;
+    }
+}
+
 void Game::run() {
-    bool running = true;
+    running = true;
+    enableRawInput();
+    loop.watchFd(spectator.getListenFd());
     
     // show menu initially
     renderer.renderMenu();
+    // Static screens (menu, pause, game over) are drawn only when entered
+    GameState shownState = MENU;
     
     while (running) {
-        frameController.startFrame();
+        // Blocks until input, a tick deadline or a signal; no ticks outside play
+        int events;
+        {
+            TRACE_SCOPE("EventLoop::wait");
+            events = loop.wait();
+        }
+        if (events & EVENT_TERMINATE) break;
+        
+        // Late joiners get a full board before their first delta
+        if (events & EVENT_WATCHED) {
+            spectator.acceptClients();
+            if (spectator.hasPendingClients()) publishKeyframe(false);
+        }
         
-        handleInput();
+        if (events & EVENT_INPUT) {
+            int bytes = readAvailableInput(pendingKeys);
+            if (bytes < 0) break; // stdin closed
+            counters.inputEvents += bytes;
+        }
         
-        switch (state) {
-            case MENU:
-                // handled in input
-                break;
-            case PLAYING:
+        // Outside of play keys are handled as soon as they arrive; while
+        // playing one key is consumed per tick
+        while (running && state != PLAYING && !pendingKeys.empty()) {
+            handleInput();
+        }
+        
+        if ((events & EVENT_TICK) && state == PLAYING) {
+            TRACE_SCOPE("Game::tick");
+            frameController.startFrame();
+            counters.ticks++;
+            handleInput();
+            if (state == PLAYING) {
                 update();
-                renderer.render(snake, food, specialFood, specialFoodActive, specialFoodTimer, specialFoodMaxTimer, score, highScore, false, obstacles, specialFoodCount);
-                break;
-            case PAUSED:
-                renderer.render(snake, food, specialFood, specialFoodActive, specialFoodTimer, specialFoodMaxTimer, score, highScore, true, obstacles, specialFoodCount);
-                break;
-            case GAME_OVER:
-                renderer.renderGameOver(score, highScore);
-                if (kbhit()) {
-                    int key = getch();
-                    if (key == ' ' || key == 'r' || key == 'R') {
-                        state = MENU;
-                        renderer.renderMenu();
-                    } else if (key == 'q' || key == 'Q') {
-                        running = false;
-                    }
+                // Subscribers (renderer, spectators) apply just this tick's changes;
+                // the renderer asks for a full frame after resets and other screens
+                journal.commit();
+                if (!renderer.isBoardShown()) {
+                    renderBoard(false);
                 }
-                break;
+                shownState = PLAYING;
+            }
+            frameController.countFrame();
+        }
+        // Quit: leave without drawing the game over screen over the shell
+        if (!running) break;
+
+        if (events & EVENT_RESIZE) {
+            redrawScreen();
+            shownState = state;
         }
         
-        frameController.endFrame();
+        if (state == PAUSED && shownState != PAUSED) {
+            renderBoard(true);
+        } else if (state == GAME_OVER && shownState != GAME_OVER) {
+            renderer.renderGameOver(engine.getScore(), highScore);
+        }
+        shownState = state;
         
         // Game speed
-        sleepMs(150);
+        loop.setTickInterval(state == PLAYING ? 1000 / frameController.getTargetFPS() : 0);
+        publishMetrics();
     }
     
+    // Every exit (Q, a closed stdin, SIGINT/SIGTERM/SIGHUP) comes through here
+    restoreInput();
+    renderer.restoreTerminal();
     saveHighScore();
-}
\ No newline at end of file
+}
@@ -2,54 +2,91 @@
 #define GAME_H
 
 #include "snake.h"
+#include "engine.h"
 #include "renderer.h"
 #include "utils.h"
-#include <random>
+#include "spectator.h"
+#include "event_loop.h"
+#include "journal.h"
+#include "game_state.h"
+#include "metrics.h"
+#include "level.h"
+#include <cstdint>
+#include <deque>
 #include <vector>
 
 enum GameState { MENU, PLAYING, PAUSED, GAME_OVER };
 
+// Screens within MENU; every step waits for the next key instead of blocking
+enum MenuScreen { MENU_MAIN, MENU_HIGH_SCORE, MENU_NAME_ENTRY };
+
 class Game {
 private:
-    static const int BOARD_WIDTH = 32;
-    static const int BOARD_HEIGHT = 24;
+    static const int DEFAULT_BOARD_WIDTH = 32;
+    static const int DEFAULT_BOARD_HEIGHT = 24;
     
-    Snake snake;
     Renderer renderer;
-    Position food;
-    Position specialFood;  // New: Special food position
-    std::vector<Position> obstacles; // New: Obstacles
-    int score;
     int highScore;
     GameState state;
     FrameRateController frameController;
-    std::mt19937 rng;
-    
-    bool specialFoodActive;  // New: Track if special food is active
-    int specialFoodTimer;    // New: Timer for special food
-    int specialFoodPoints;   // New: Points for special food
-    int specialFoodMaxTimer; // New: Max timer for special food (for timeline)
     
-    // New: player/high score names and rare food counter
+    // New: player/high score names
     std::string playerName;
     std::string highScoreName;
-    int specialFoodCount;
     
-    void generateFood();
-    void generateSpecialFood();  // New: Generate special food
-    void generateObstacles(int count); // New: Generate obstacles
+    SpectatorFeed spectator;
+    ChangeJournal journal; // per-tick changes, committed to renderer and spectators
+    
+    EventLoop loop;
+    std::deque<int> pendingKeys; // bytes read from stdin, not yet handled
+    bool running;
+    MenuScreen menuScreen;
+    std::string nameInput; // typed so far on the name entry screen
+    
+    MetricsExporter metrics;
+    RuntimeCounters counters;
+    
+    std::vector<Level> levels; // the built-in board, or the levels given on the command line
+    size_t currentLevel;
+    GameEngine engine; // snake, food, obstacles and score on the current level
+    
+    const Level& level() const { return levels[currentLevel]; }
+    void switchLevel(size_t index);
+    int nextKey();
     void handleInput();
     void update();
+    void endGame();
     void resetGame();
     void saveHighScore();
     void loadHighScore();
     
     // New helpers
-    void askPlayerName();
+    void handleMenuKey(int key);
+    void handleNameKey(int key);
     void saveScoreEntry();
+    void publishKeyframe(bool toAll);
+    void renderBoard(bool paused);
+    void redrawScreen();
+    void publishMetrics();
     
 public:
-    Game();
+    explicit Game(RenderMode renderMode = RENDER_EMOJI, uint64_t seed = 5489u);
+    
+    // Compact save/restore of the board, snake and counters. snapshot() fails
+    // when the snake or obstacles don't fit; restore() when the level the
+    // snapshot was taken on isn't loaded or the snapshot is malformed
+    // (see GameEngine::restore()).
+    bool snapshot(CompactGameState& out) const;
+    bool restore(const CompactGameState& in);
+    // Without SNAKE_RNG_COMPACT the RNG isn't in the snapshot; save and
+    // restore it with these to keep the food placement of the original game
+    const GameRng& getRng() const { return engine.getRng(); }
+    void setRng(const GameRng& state) { engine.setRng(state); }
+    // Adds a level file to the rotation (N switches level while playing);
+    // the first one replaces the built-in board
+    bool loadLevel(const std::string& path);
+    bool enableSpectatorFeed(const std::string& socketPath);
+    bool enableMetrics(const std::string& shmName);
     void run();
 };
 
@@ -0,0 +1,55 @@
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include "snake.h"
+#include "rng.h"
+#include <cstdint>
+#include <type_traits>
+
+// 16-bit packed cell: x in the low byte, y in the high byte
+typedef uint16_t PackedPos;
+
+inline PackedPos packPos(const Position& p) {
+    return static_cast<PackedPos>(((p.y & 0xFF) << 8) | (p.x & 0xFF));
+}
+
+inline Position unpackPos(PackedPos v) {
+    return Position(v & 0xFF, v >> 8);
+}
+
+const int COMPACT_MAX_LENGTH = 32 * 24;
+const int COMPACT_MAX_OBSTACLES = 16;
+
+// Everything needed to resume a game, in one flat block: no pointers, no
+// heap, copied and stored with memcpy. The snake body is stored head first
+// as packed cells.
+// With a compact RNG (PCG32, xoshiro) its state is included, so a restored
+// game places food exactly where the original would have; the 5 KB mt19937
+// state is left out and goes through GameEngine::getRng()/setRng() instead.
+struct CompactGameState {
+    uint8_t width;
+    uint8_t height;
+    uint8_t state;              // GameState
+    uint8_t direction;          // Direction
+    uint32_t levelChecksum;     // Level::getChecksum(), 0 for the built-in board
+    int32_t score;
+    int32_t specialFoodCount;
+    int16_t specialFoodTimer;
+    uint8_t specialFoodActive;
+    uint8_t obstacleCount;
+    PackedPos food;
+    PackedPos specialFood;
+    uint16_t length;
+#ifdef SNAKE_RNG_COMPACT
+    GameRng rng;
+#endif
+    PackedPos obstacles[COMPACT_MAX_OBSTACLES];
+    PackedPos body[COMPACT_MAX_LENGTH];
+
+    Position segment(int i) const { return unpackPos(body[i]); }
+};
+
+static_assert(std::is_trivially_copyable<CompactGameState>::value,
+              "CompactGameState must stay memcpy-able");
+
+#endif
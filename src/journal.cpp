@@ -0,0 +1,28 @@
+#include "journal.h"
+#include <algorithm>
+
+void ChangeJournal::subscribe(ChangeListener* listener) {
+    if (std::find(listeners.begin(), listeners.end(), listener) == listeners.end()) {
+        listeners.push_back(listener);
+    }
+}
+
+void ChangeJournal::unsubscribe(ChangeListener* listener) {
+    listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+}
+
+void ChangeJournal::record(ChangeType type, const Position& pos, int value) {
+    Change change;
+    change.type = type;
+    change.pos = pos;
+    change.value = value;
+    changes.push_back(change);
+}
+
+void ChangeJournal::commit() {
+    if (changes.empty()) return;
+    for (ChangeListener* listener : listeners) {
+        listener->onChanges(changes);
+    }
+    changes.clear(); // keeps capacity, so steady-state ticks do not allocate
+}
@@ -0,0 +1,55 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "snake.h"
+#include <vector>
+
+// What changed during one tick. Cell changes carry a position; counters
+// carry their new value.
+enum ChangeType {
+    CHANGE_HEAD_MOVED,       // pos: new head cell
+    CHANGE_BODY_ADDED,       // pos: the old head, now a body segment
+    CHANGE_TAIL_FREED,       // pos: cell the snake no longer covers
+    CHANGE_FOOD_SPAWNED,     // pos
+    CHANGE_SPECIAL_SPAWNED,  // pos, value: ticks until it expires
+    CHANGE_SPECIAL_CLEARED,  // pos: where it was (eaten or expired)
+    CHANGE_SPECIAL_TIMER,    // value: ticks left
+    CHANGE_SCORE,            // value
+    CHANGE_LENGTH,           // value
+    CHANGE_RARE_COUNT,       // value: special foods eaten
+    CHANGE_HIGH_SCORE,       // value
+    CHANGE_GAME_OVER,
+    CHANGE_RESET             // whole board replaced; consumers resync from full state
+};
+
+struct Change {
+    ChangeType type;
+    Position pos;
+    int value;
+};
+
+class ChangeListener {
+public:
+    virtual ~ChangeListener() {}
+    virtual void onChanges(const std::vector<Change>& changes) = 0;
+};
+
+// Collects the changes of the current tick and hands them to every
+// subscriber on commit(), so consumers work in O(changes), not O(board).
+class ChangeJournal {
+private:
+    std::vector<Change> changes;
+    std::vector<ChangeListener*> listeners;
+
+public:
+    void subscribe(ChangeListener* listener);
+    void unsubscribe(ChangeListener* listener);
+
+    void record(ChangeType type, const Position& pos = Position(), int value = 0);
+    void record(ChangeType type, int value) { record(type, Position(), value); }
+    void commit();
+
+    const std::vector<Change>& pending() const { return changes; }
+};
+
+#endif
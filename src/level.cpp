@@ -0,0 +1,124 @@
+#include "level.h"
+#include <cstring>
+#include <iostream>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+uint32_t levelChecksum(const unsigned char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+Level::Level(int width, int height)
+    : width(width), height(height), name("Open field"), checksum(0), builtIn(true) {
+    LevelSpawn center = { static_cast<uint8_t>(width / 2), static_cast<uint8_t>(height / 2),
+                          static_cast<uint8_t>(RIGHT), 0 };
+    spawns.push_back(center);
+    buildLayers(nullptr, nullptr);
+}
+
+void Level::buildLayers(const unsigned char* wallBits, const unsigned char* exclusionBits) {
+    const int rowBytes = (width + 7) / 8;
+    layer.assign(width * height, 0);
+    walls.clear();
+    freeCells.clear();
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int byte = y * rowBytes + x / 8;
+            int bit = 1 << (x % 8);
+            unsigned char flags = 0;
+            if (wallBits && (wallBits[byte] & bit)) flags |= CELL_WALL;
+            if (exclusionBits && (exclusionBits[byte] & bit)) flags |= CELL_NO_FOOD;
+            layer[y * width + x] = flags;
+            if (flags & CELL_WALL) walls.push_back(Position(x, y));
+            else if (flags == 0) freeCells.push_back(Position(x, y));
+        }
+    }
+}
+
+bool Level::fromBytes(const unsigned char* data, size_t size, const std::string& source) {
+    if (size < sizeof(LevelFileHeader)) {
+        std::cerr << "Level: " << source << " is too small\n";
+        return false;
+    }
+    LevelFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const unsigned char* payload = data + sizeof(header);
+    const size_t rowBytes = (header.width + 7) / 8;
+    const size_t bitmapBytes = rowBytes * header.height;
+
+    const char* error = nullptr;
+    if (header.magic != LEVEL_MAGIC) error = "not a level file";
+    else if (header.version != LEVEL_VERSION) error = "unsupported version";
+    else if (header.width < 2 || header.height < 2 || header.width > LEVEL_MAX_SIDE || header.height > LEVEL_MAX_SIDE) error = "bad dimensions";
+    else if (header.payloadSize != size - sizeof(header) ||
+             header.payloadSize != 2 * bitmapBytes + header.spawnCount * sizeof(LevelSpawn)) error = "truncated or oversized";
+    else if (levelChecksum(payload, header.payloadSize) != header.checksum) error = "checksum mismatch";
+    else if (header.spawnCount == 0) error = "no spawn points";
+
+    if (!error) {
+        Level loaded(header.width, header.height);
+        loaded.name = source;
+        loaded.checksum = header.checksum;
+        loaded.builtIn = false;
+        loaded.buildLayers(payload, payload + bitmapBytes);
+        loaded.spawns.assign(reinterpret_cast<const LevelSpawn*>(payload + 2 * bitmapBytes),
+                             reinterpret_cast<const LevelSpawn*>(payload + 2 * bitmapBytes) + header.spawnCount);
+        for (const auto& s : loaded.spawns) {
+            if (s.x >= header.width || s.y >= header.height || s.direction > RIGHT ||
+                loaded.isWall(Position(s.x, s.y))) {
+                error = "spawn point outside the board or inside a wall";
+            }
+        }
+        // A new game needs a food cell besides the one the snake starts on
+        if (loaded.freeCells.size() < 2) error = "needs at least two cells food can spawn on";
+        if (!error) *this = loaded;
+    }
+
+    if (error) {
+        std::cerr << "Level: " << source << ": " << error << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool Level::load(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    std::cerr << "Level files are not supported on Windows\n";
+    return false;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Level: cannot open " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(LevelFileHeader))) {
+        std::cerr << "Level: " << path << " is too small\n";
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void* mem = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        std::cerr << "Level: cannot map " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    // The bitmaps are read in place; only the precomputed layers are kept
+    bool ok = fromBytes(static_cast<const unsigned char*>(mem), size, path);
+    munmap(mem, size);
+    return ok;
+#endif
+}
@@ -0,0 +1,88 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "snake.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const uint32_t LEVEL_MAGIC = 0x4C4B4E53; // "SNKL"
+const uint16_t LEVEL_VERSION = 1;
+const int LEVEL_MAX_SIDE = 255; // positions are packed into one byte per axis
+
+// Binary level file, little-endian, mapped and used in place:
+//   LevelFileHeader
+//   u8 walls[rowBytes * height]          bit (x % 8) of byte y * rowBytes + x / 8
+//   u8 foodExclusion[rowBytes * height]  same layout; food never spawns there
+//   LevelSpawn spawns[spawnCount]
+// with rowBytes = (width + 7) / 8. The checksum is levelChecksum() of
+// everything after the header. tools/snake_levelmaker.cpp writes these files.
+struct LevelFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t width;
+    uint16_t height;
+    uint16_t spawnCount;
+    uint32_t payloadSize;
+    uint32_t checksum;
+};
+
+struct LevelSpawn {
+    uint8_t x;
+    uint8_t y;
+    uint8_t direction; // Direction
+    uint8_t reserved;
+};
+
+static_assert(sizeof(LevelFileHeader) == 20, "LevelFileHeader must match the file layout");
+static_assert(sizeof(LevelSpawn) == 4, "LevelSpawn must match the file layout");
+
+// 32-bit FNV-1a
+uint32_t levelChecksum(const unsigned char* data, size_t size);
+
+// Static part of a board: walls, food exclusion zones and spawn points, with
+// the per-cell layer and free-cell list precomputed once so spawning and
+// collisions only have to look at the snake, food and random obstacles.
+class Level {
+private:
+    enum CellFlag : unsigned char { CELL_WALL = 1, CELL_NO_FOOD = 2 };
+
+    int width, height;
+    std::string name;
+    uint32_t checksum;
+    bool builtIn;
+    std::vector<unsigned char> layer;  // CellFlag bits per cell
+    std::vector<Position> walls;
+    std::vector<Position> freeCells;   // cells food may spawn on
+    std::vector<LevelSpawn> spawns;
+
+    void buildLayers(const unsigned char* wallBits, const unsigned char* exclusionBits);
+
+public:
+    // An open board with no walls, spawning in the middle (the original game)
+    Level(int width = 32, int height = 24);
+
+    // Maps and validates a level file; on failure the level is unchanged
+    bool load(const std::string& path);
+    // Same for a level image already in memory (the whole file, header first)
+    bool fromBytes(const unsigned char* data, size_t size, const std::string& source);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const std::string& getName() const { return name; }
+    uint32_t getChecksum() const { return checksum; }
+    // Built-in boards get random obstacles; level files bring their own walls
+    bool isBuiltIn() const { return builtIn; }
+
+    bool isWall(const Position& p) const { return (layer[p.y * width + p.x] & CELL_WALL) != 0; }
+    bool allowsFood(const Position& p) const { return layer[p.y * width + p.x] == 0; }
+    const std::vector<Position>& getWalls() const { return walls; }
+    const std::vector<Position>& getFreeCells() const { return freeCells; }
+
+    int getSpawnCount() const { return static_cast<int>(spawns.size()); }
+    Position getSpawn(int index) const { return Position(spawns[index].x, spawns[index].y); }
+    Direction getSpawnDirection(int index) const { return static_cast<Direction>(spawns[index].direction); }
+};
+
+#endif
@@ -1,18 +1,55 @@
 #include "game.h"
 #include "utils.h"
 #include <iostream>
+#include <string>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
-int main() {
+int main(int argc, char* argv[]) {
 #ifdef _WIN32
     // Enable UTF-8 for emoji support
     SetConsoleOutputCP(CP_UTF8);
     SetConsoleCP(CP_UTF8);
+    enableVirtualTerminal();
 #endif
     try {
-        Game game;
+        RenderMode renderMode = detectRenderMode();
+        std::string spectatePath;
+        std::string metricsName;
+        std::vector<std::string> levelPaths;
+        std::random_device entropy;
+        uint64_t seed = (static_cast<uint64_t>(entropy()) << 32) | entropy();
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--spectate" && i + 1 < argc) {
+                spectatePath = argv[++i];
+            } else if (arg == "--metrics" && i + 1 < argc) {
+                metricsName = argv[++i];
+            } else if (arg == "--level" && i + 1 < argc) {
+                levelPaths.push_back(argv[++i]);
+            } else if (arg == "--seed" && i + 1 < argc) {
+                seed = std::strtoull(argv[++i], nullptr, 0);
+            } else if (arg == "--render" && i + 1 < argc && parseRenderMode(argv[i + 1], renderMode)) {
+                ++i;
+            } else {
+                std::cerr << "Usage: " << argv[0]
+                          << " [--render emoji|ascii|halfblock] [--seed N] [--spectate SOCKET_PATH]"
+                          << " [--metrics SHM_NAME] [--level FILE]...\n";
+                return 1;
+            }
+        }
+        
+        Game game(renderMode, seed);
+        for (const auto& path : levelPaths) {
+            if (!game.loadLevel(path)) return 1;
+        }
+        if (!spectatePath.empty() && !game.enableSpectatorFeed(spectatePath)) return 1;
+        if (!metricsName.empty() && !game.enableMetrics(metricsName)) return 1;
         game.run();
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << std::endl;
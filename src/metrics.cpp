@@ -0,0 +1,121 @@
+#include "metrics.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+
+#ifndef _WIN32
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+// Forwards everything to the real stdout buffer and counts the bytes
+class CountingStreambuf : public std::streambuf {
+private:
+    std::streambuf* target;
+
+protected:
+    int overflow(int ch) override {
+        if (ch == traits_type::eof()) return traits_type::not_eof(ch);
+        count++;
+        return target->sputc(static_cast<char>(ch));
+    }
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        count += static_cast<uint64_t>(n);
+        return target->sputn(s, n);
+    }
+    int sync() override { return target->pubsync(); }
+
+public:
+    uint64_t count;
+    explicit CountingStreambuf(std::streambuf* target) : target(target), count(0) {}
+};
+
+MetricsExporter::MetricsExporter() : block(nullptr), originalCoutBuf(nullptr), countingBuf(nullptr) {}
+
+MetricsExporter::~MetricsExporter() {
+    close();
+}
+
+bool MetricsExporter::open(const std::string& shmName) {
+#ifdef _WIN32
+    (void)shmName;
+    std::cerr << "Shared-memory metrics are not supported on Windows\n";
+    return false;
+#else
+    close();
+    int fd = shm_open(shmName.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Metrics: cannot create " << shmName << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+    if (ftruncate(fd, sizeof(MetricsBlock)) != 0) {
+        ::close(fd);
+        shm_unlink(shmName.c_str());
+        return false;
+    }
+    void* mem = mmap(nullptr, sizeof(MetricsBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) {
+        shm_unlink(shmName.c_str());
+        return false;
+    }
+
+    block = static_cast<MetricsBlock*>(mem);
+    std::memset(mem, 0, sizeof(MetricsBlock));
+    block->magic = METRICS_MAGIC;
+    block->version = METRICS_VERSION;
+    block->size = sizeof(MetricsBlock);
+    block->pid = static_cast<uint32_t>(getpid());
+    name = shmName;
+
+    originalCoutBuf = std::cout.rdbuf();
+    countingBuf = new CountingStreambuf(originalCoutBuf);
+    std::cout.rdbuf(countingBuf);
+    return true;
+#endif
+}
+
+void MetricsExporter::close() {
+    if (countingBuf) {
+        std::cout.flush();
+        std::cout.rdbuf(originalCoutBuf);
+        delete countingBuf;
+        countingBuf = nullptr;
+    }
+#ifndef _WIN32
+    if (block) {
+        munmap(block, sizeof(MetricsBlock));
+        shm_unlink(name.c_str());
+    }
+#endif
+    block = nullptr;
+}
+
+uint64_t MetricsExporter::getTerminalBytes() const {
+    return countingBuf ? countingBuf->count : 0;
+}
+
+void MetricsExporter::publish(const RuntimeCounters& counters) {
+    if (!block) return;
+
+    // Seqlock writer: odd while the fields are being rewritten
+    uint32_t seq = block->sequence.load(std::memory_order_relaxed);
+    block->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    block->state = counters.state;
+    block->ticks = counters.ticks;
+    block->framesRendered = counters.framesRendered;
+    block->bytesWritten = counters.bytesWritten;
+    block->inputEvents = counters.inputEvents;
+    block->foodSpawnAttempts = counters.foodSpawnAttempts;
+    block->fps = counters.fps;
+    block->publishTimeNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+
+    block->sequence.store(seq + 2, std::memory_order_release);
+}
@@ -0,0 +1,69 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+const uint32_t METRICS_MAGIC = 0x4D4B4E53; // "SNKM"
+const uint32_t METRICS_VERSION = 1;
+
+// Layout of the shared-memory metrics segment. A monitor maps it read-only
+// and reads it without any call into the game:
+//   1. s1 = sequence; retry while odd (an update is in progress)
+//   2. copy the fields
+//   3. s2 = sequence; the copy is consistent if s1 == s2
+// New fields are only ever appended; bump METRICS_VERSION when they are.
+struct MetricsBlock {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t size;                 // sizeof(MetricsBlock) for this version
+    uint32_t pid;
+    std::atomic<uint32_t> sequence;
+    uint32_t state;                // GameState
+    uint64_t ticks;                // game ticks simulated
+    uint64_t framesRendered;       // full frames plus incremental patches
+    uint64_t bytesWritten;         // bytes written to the terminal
+    uint64_t inputEvents;          // key bytes handled
+    uint64_t foodSpawnAttempts;    // random cells tried by generateFood/generateSpecialFood
+    uint32_t fps;                  // FrameRateController::getFPS()
+    uint32_t reserved;
+    uint64_t publishTimeNs;        // steady clock at the last update
+};
+
+// Counters as accumulated inside the process between publishes
+struct RuntimeCounters {
+    uint64_t ticks;
+    uint64_t framesRendered;
+    uint64_t bytesWritten;
+    uint64_t inputEvents;
+    uint64_t foodSpawnAttempts;
+    uint32_t fps;
+    uint32_t state;
+};
+
+class CountingStreambuf;
+
+// Owns the segment and the seqlock writer side
+class MetricsExporter {
+private:
+    MetricsBlock* block;
+    std::string name;
+    std::streambuf* originalCoutBuf;
+    CountingStreambuf* countingBuf;
+
+public:
+    MetricsExporter();
+    ~MetricsExporter();
+
+    // Creates the POSIX shared memory object (e.g. "/snake-metrics") and
+    // starts counting bytes written through std::cout
+    bool open(const std::string& shmName);
+    void close();
+    bool isOpen() const { return block != nullptr; }
+
+    uint64_t getTerminalBytes() const;
+    void publish(const RuntimeCounters& counters);
+};
+
+#endif
@@ -1,11 +1,140 @@
 #include "renderer.h"
 #include "utils.h"
+#include "trace.h"
 #include <iostream>
 #include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
 
-Renderer::Renderer(int width, int height) 
-    : boardWidth(width), boardHeight(height) {
-    screenBuffer.resize(boardHeight + 7);
+enum CellKind { CELL_EMPTY, CELL_HEAD, CELL_BODY, CELL_OBSTACLE, CELL_SPECIAL, CELL_FOOD, CELL_BORDER, CELL_KIND_COUNT };
+
+// Everything the renderer prints, per render mode. HALFBLOCK shares the ASCII
+// text and draws the board from HALFBLOCK_COLORS instead of cell glyphs.
+struct GlyphSet {
+    const char* cell[CELL_KIND_COUNT]; // CELL_BORDER is the vertical border
+    const char* corner;
+    const char* hBorder;
+    const char* title;
+    const char* scoreLabel;
+    const char* lengthLabel;
+    const char* rareLabel;
+    const char* controlsHint;
+    const char* legendHeadBody;
+    const char* legendFood;
+    const char* legendObstacle;
+    const char* timerOpen;
+    const char* timerFill;
+    const char* specialActive;
+    const char* controls;
+    const char* paused;
+    const char* gameOver;
+    const char* finalScore;
+    const char* gameOverHint;
+    const char* menu;
+    const char* highScoreTitle;
+    const char* highScorePlayer;
+    const char* highScoreScore;
+    const char* highScoreReturn;
+};
+
+static const GlyphSet EMOJI_GLYPHS = {
+    { "  ", "🐍", "🟢", "🧱", "🌟", "🍎", "🔹" },
+    "🔶", "➖",
+    "🐍 S N A K E  G A M E 🐍    🏆 High: ",
+    "📊 Score: ", "📏 Length: ", "🌟 Rare foods: ", "🎮 WASD/Arrows",
+    "🐍 head  🟢 body", "🍎 food  🌟 special", "🧱 obstacle",
+    "⏳[", "█",
+    "🌟 SPECIAL FOOD ACTIVE! +30 points!",
+    "🎮 Controls: WASD/Arrow Keys | ⏸️  P | 🔄 R | ❌ Q",
+    "⏸️  PAUSED - Press P to continue",
+    "\n💀 GAME OVER! 💀\n",
+    "🏆 Final Score: ",
+    "🔄 Press SPACE or R to return to menu | ❌ Q to quit\n",
+    "🐍 === SNAKE GAME === 🐍\n1. 🎮 Start Game\n2. 🏆 Highest Score\n3. ❌ Exit\n🎯 Select option: ",
+    "🏆 Highest Score\n", "👤 Player: ", "📊 Score : ",
+    "↩️  Press any key to return to menu..."
+};
+
+static const GlyphSet ASCII_GLYPHS = {
+    { " ", "@", "o", "#", "$", "*", "|" },
+    "+", "-",
+    "S N A K E  G A M E    High: ",
+    "Score: ", "Length: ", "Rare foods: ", "WASD/Arrows",
+    "@ head  o body", "* food  $ special", "# obstacle",
+    "[", "=",
+    "SPECIAL FOOD ACTIVE! +30 points!",
+    "Controls: WASD/Arrows | P pause | R restart | Q quit",
+    "PAUSED - Press P to continue",
+    "\nGAME OVER!\n",
+    "Final Score: ",
+    "Press SPACE or R to return to menu | Q to quit\n",
+    "=== SNAKE GAME ===\n1. Start Game\n2. Highest Score\n3. Exit\nSelect option: ",
+    "Highest Score\n", "Player: ", "Score : ",
+    "Press any key to return to menu..."
+};
+
+// Rows of the panel right of the board; it runs past the bottom of short boards
+static const int SIDEBAR_ROWS = 10;
+
+// 256-color palette index per cell kind for RENDER_HALFBLOCK
+static const int HALFBLOCK_COLORS[CELL_KIND_COUNT] = { 234, 118, 34, 130, 226, 196, 25 };
+
+static const GlyphSet& glyphsFor(RenderMode mode) {
+    return mode == RENDER_EMOJI ? EMOJI_GLYPHS : ASCII_GLYPHS;
+}
+
+static bool envContains(const char* name, const char* needle) {
+    const char* value = std::getenv(name);
+    if (!value) return false;
+    std::string v(value);
+    for (auto& c : v) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return v.find(needle) != std::string::npos;
+}
+
+RenderMode detectRenderMode() {
+#ifdef _WIN32
+    return RENDER_EMOJI;
+#else
+    const char* term = std::getenv("TERM");
+    if (!term || !*term || std::strcmp(term, "dumb") == 0 || std::strcmp(term, "linux") == 0 ||
+        std::strncmp(term, "vt", 2) == 0) {
+        return RENDER_ASCII;
+    }
+    // The first non-empty of LC_ALL, LC_CTYPE, LANG decides the charset
+    const char* vars[] = { "LC_ALL", "LC_CTYPE", "LANG" };
+    for (const char* var : vars) {
+        const char* value = std::getenv(var);
+        if (value && *value) {
+            return (envContains(var, "utf-8") || envContains(var, "utf8")) ? RENDER_EMOJI : RENDER_ASCII;
+        }
+    }
+    return RENDER_ASCII;
+#endif
+}
+
+bool parseRenderMode(const std::string& name, RenderMode& mode) {
+    if (name == "emoji") mode = RENDER_EMOJI;
+    else if (name == "ascii") mode = RENDER_ASCII;
+    else if (name == "halfblock") mode = RENDER_HALFBLOCK;
+    else return false;
+    return true;
+}
+
+Renderer::Renderer(int width, int height, RenderMode mode)
+    : boardWidth(width), boardHeight(height), mode(mode), hud(), boardShown(false), framesRendered(0) {
+    screenBuffer.resize(1 + panelLines() + FOOTER_LINES);
+    cells.resize(boardWidth * boardHeight);
+}
+
+void Renderer::setBoard(int width, int height, const std::vector<Position>& levelWalls) {
+    boardWidth = width;
+    boardHeight = height;
+    walls = levelWalls;
+    screenBuffer.assign(1 + panelLines() + FOOTER_LINES, std::string());
+    cells.assign(boardWidth * boardHeight, static_cast<unsigned char>(CELL_EMPTY));
+    invalidate();
 }
 
 void Renderer::clearBuffer() {
@@ -15,7 +144,7 @@ void Renderer::clearBuffer() {
 }
 
 void Renderer::drawToBuffer(int x, int y, const std::string& content) {
-    if (y >= 0 && y < screenBuffer.size()) {
+    if (y >= 0 && y < static_cast<int>(screenBuffer.size())) {
         if (x + content.length() > screenBuffer[y].length()) {
             screenBuffer[y].resize(x + content.length(), ' ');
         }
@@ -23,178 +152,423 @@ void Renderer::drawToBuffer(int x, int y, const std::string& content) {
     }
 }
 
-void Renderer::render(const Snake& snake, const Position& food, const Position& specialFood, 
-                     bool specialFoodActive, int specialFoodTimer, int specialFoodMaxTimer,
-                     int score, int highScore, bool paused,
-                     const std::vector<Position>& obstacles,
-                     int specialFoodCount) {
-    clearBuffer();
-    
-    static bool first = true;
-    if (first) {
-        std::cout << "\033[2J\033[?25l"; // clear once and hide cursor
-        first = false;
-    }
-    
-    int bufferY = 0;
-    const int leftPad = 2;
-    const std::string pad(leftPad, ' ');
-    
-    // Game title with high score (padded)
-    std::stringstream title;
-    title << pad << "🐍 S N A K E  G A M E 🐍    🏆 High: " << highScore;
-    drawToBuffer(0, bufferY++, title.str() + "        ");
-    
-    // Top border
-    std::string topBorder = pad + "🔶";
-    for (int i = 0; i < boardWidth; i++) topBorder += "➖";
-    topBorder += "🔶";
-    drawToBuffer(0, bufferY++, topBorder);
-    
-    // Game board with special food and obstacles
-    for (int y = 0; y < boardHeight; y++) {
-        std::string line = pad + "🔹";
-        for (int x = 0; x < boardWidth; x++) {
-            bool isObstacle = false;
-            for (const auto& ob : obstacles) {
-                if (ob.x == x && ob.y == y) { isObstacle = true; break; }
-            }
-            if (snake.getHead().x == x && snake.getHead().y == y) {
-                line += "🐍";
-            } else if (snake.isOnPosition(x, y)) {
-                line += "🟢";
-            } else if (isObstacle) {
-                line += "🧱"; // obstacle
-            } else if (specialFoodActive && specialFood.x == x && specialFood.y == y) {
-                line += "🌟";  // Special food - star emoji
-            } else if (food.x == x && food.y == y) {
-                line += "🍎";
-            } else {
-                line += "  ";
-            }
-        }
-        line += "🔹";
-        // Right-side panel content aligned with board rows
-        std::string sidebar = "  ";
-        if (y == 0) {
-            std::stringstream ss; ss << "📊 Score: " << score; sidebar += ss.str();
-        } else if (y == 1) {
-            std::stringstream ss; ss << "📏 Length: " << snake.getLength(); sidebar += ss.str();
-        } else if (y == 2) {
-            std::stringstream ss; ss << "🌟 Rare foods: " << specialFoodCount; sidebar += ss.str();
-        } else if (y == 3) {
-            sidebar += "🎮 WASD/Arrows";
-        } else if (y == 4) {
-            sidebar += "Legend:";
-        } else if (y == 5) {
-            sidebar += "🐍 head  🟢 body";
-        } else if (y == 6) {
-            sidebar += "🍎 food  🌟 special";
-        } else if (y == 7) {
-            sidebar += "🧱 obstacle";
-        } else if (y == 9 && specialFoodActive && specialFoodTimer > 0 && specialFoodMaxTimer > 0) {
-            int barWidth = 16;
-            int t = specialFoodTimer; if (t < 0) t = 0; if (t > specialFoodMaxTimer) t = specialFoodMaxTimer;
-            int filled = static_cast<int>((static_cast<double>(t) / specialFoodMaxTimer) * barWidth + 0.5);
-            if (filled < 0) filled = 0; if (filled > barWidth) filled = barWidth;
-            std::string bar = "⏳[";
-            for (int i = 0; i < filled; ++i) bar += "█";
-            for (int i = 0; i < barWidth - filled; ++i) bar += " ";
-            bar += "]";
-            sidebar += bar;
+void Renderer::fillCells(const Snake& snake, const Position& food, const Position& specialFood,
+                         bool specialFoodActive, const std::vector<Position>& obstacles) {
+    // Lowest priority first so head > body > obstacle > special food > food
+    std::fill(cells.begin(), cells.end(), static_cast<unsigned char>(CELL_EMPTY));
+    auto put = [this](const Position& p, CellKind kind) {
+        if (p.x >= 0 && p.x < boardWidth && p.y >= 0 && p.y < boardHeight) {
+            cells[p.y * boardWidth + p.x] = static_cast<unsigned char>(kind);
         }
-        line += sidebar;
-        drawToBuffer(0, bufferY++, line);
+    };
+    put(food, CELL_FOOD);
+    if (specialFoodActive) put(specialFood, CELL_SPECIAL);
+    for (const auto& wall : walls) put(wall, CELL_OBSTACLE);
+    for (const auto& ob : obstacles) put(ob, CELL_OBSTACLE);
+    for (const auto& segment : snake.getBody()) put(segment, CELL_BODY);
+    put(snake.getHead(), CELL_HEAD);
+}
+
+std::string Renderer::titleLine() const {
+    std::stringstream title;
+    title << "  " << glyphsFor(mode).title << hud.highScore;
+    return title.str();
+}
+
+std::string Renderer::sidebarLine(int row) const {
+    const GlyphSet& g = glyphsFor(mode);
+    std::stringstream ss;
+    ss << "  ";
+    if (row == 0) {
+        ss << g.scoreLabel << hud.score;
+    } else if (row == 1) {
+        ss << g.lengthLabel << hud.length;
+    } else if (row == 2) {
+        ss << g.rareLabel << hud.specialFoodCount;
+    } else if (row == 3) {
+        ss << g.controlsHint;
+    } else if (row == 4) {
+        ss << "Legend:";
+    } else if (row == 5) {
+        ss << g.legendHeadBody;
+    } else if (row == 6) {
+        ss << g.legendFood;
+    } else if (row == 7) {
+        ss << g.legendObstacle;
+    } else if (row == 9 && hud.specialFoodActive && hud.specialFoodTimer > 0 && hud.specialFoodMaxTimer > 0) {
+        int barWidth = 16;
+        int t = hud.specialFoodTimer; if (t < 0) t = 0; if (t > hud.specialFoodMaxTimer) t = hud.specialFoodMaxTimer;
+        int filled = static_cast<int>((static_cast<double>(t) / hud.specialFoodMaxTimer) * barWidth + 0.5);
+        if (filled < 0) filled = 0;
+        if (filled > barWidth) filled = barWidth;
+        ss << g.timerOpen;
+        for (int i = 0; i < filled; ++i) ss << g.timerFill;
+        for (int i = 0; i < barWidth - filled; ++i) ss << ' ';
+        ss << ']';
     }
-    
-    // Bottom border
-    std::string bottomBorder = pad + "🔶";
-    for (int i = 0; i < boardWidth; i++) bottomBorder += "➖";
-    bottomBorder += "🔶";
-    drawToBuffer(0, bufferY++, bottomBorder);
-    
-    // Footer info (padded)
-    std::stringstream scoreInfo;
-    scoreInfo << pad << "📊 Score: " << score << " | 📏 Length: " << snake.getLength();
-    drawToBuffer(0, bufferY++, scoreInfo.str() + "          ");
-    
-    // Special food indicator + emoji timeline
-    if (specialFoodActive && specialFoodTimer > 0) {
-        std::string specialInfo = pad + "🌟 SPECIAL FOOD ACTIVE! +30 points!";
-        drawToBuffer(0, bufferY++, specialInfo + "      ");
+    return ss.str();
+}
 
+std::string Renderer::footerLine(int index) const {
+    const GlyphSet& g = glyphsFor(mode);
+    const std::string pad(2, ' ');
+    bool specialShown = hud.specialFoodActive && hud.specialFoodTimer > 0;
+    if (index == FOOTER_SCORE) {
+        std::stringstream scoreInfo;
+        scoreInfo << pad << g.scoreLabel << hud.score << " | " << g.lengthLabel << hud.length;
+        return scoreInfo.str();
+    } else if (index == FOOTER_SPECIAL && specialShown) {
+        return pad + g.specialActive;
+    } else if (index == FOOTER_TIMER && specialShown) {
+        // Special food timeline
         int barWidth = 30;
-        int clampedMax = specialFoodMaxTimer > 0 ? specialFoodMaxTimer : 1;
-        if (specialFoodTimer < 0) specialFoodTimer = 0;
-        if (specialFoodTimer > clampedMax) specialFoodTimer = clampedMax;
-        double fraction = static_cast<double>(specialFoodTimer) / static_cast<double>(clampedMax);
+        int clampedMax = hud.specialFoodMaxTimer > 0 ? hud.specialFoodMaxTimer : 1;
+        int timer = hud.specialFoodTimer;
+        if (timer > clampedMax) timer = clampedMax;
+        double fraction = static_cast<double>(timer) / static_cast<double>(clampedMax);
         int filled = static_cast<int>(fraction * barWidth + 0.5);
         if (filled < 0) filled = 0;
         if (filled > barWidth) filled = barWidth;
 
-        std::string bar = "⏳[";
-        for (int i = 0; i < filled; ++i) bar += "█";
+        std::string bar = g.timerOpen;
+        for (int i = 0; i < filled; ++i) bar += g.timerFill;
         for (int i = 0; i < barWidth - filled; ++i) bar += " ";
         bar += "] ";
         std::stringstream remain;
-        remain << bar << specialFoodTimer << "/" << clampedMax;
-        drawToBuffer(0, bufferY++, pad + remain.str() + "      ");
-    } else {
-        // Clear the special food lines (two lines) with plenty of spaces to overwrite any previous content
-        drawToBuffer(0, bufferY++, pad + "                                                                                                  ");
-        drawToBuffer(0, bufferY++, pad + "                                                                                                  ");
-    }
-    
-    std::string controls = pad + "🎮 Controls: WASD/Arrow Keys | ⏸️  P | 🔄 R | ❌ Q";
-    drawToBuffer(0, bufferY++, controls + "    ");
-    
-    if (paused) {
-        drawToBuffer(0, bufferY, pad + "⏸️  PAUSED - Press P to continue                    ");
+        remain << bar << timer << "/" << clampedMax;
+        return pad + remain.str();
+    } else if (index == FOOTER_CONTROLS) {
+        return pad + g.controls;
+    } else if (index == FOOTER_PAUSED && hud.paused) {
+        return pad + g.paused;
+    }
+    return std::string();
+}
+
+int Renderer::boardLines() const {
+    return mode == RENDER_HALFBLOCK ? (boardHeight + 3) / 2 : boardHeight + 2;
+}
+
+int Renderer::panelLines() const {
+    return std::max(boardLines(), sidebarRow(SIDEBAR_ROWS - 1));
+}
+
+int Renderer::sidebarRow(int row) const {
+    return mode == RENDER_HALFBLOCK ? 1 + row : 2 + row;
+}
+
+int Renderer::sidebarColumn() const {
+    int cellWidth = (mode == RENDER_EMOJI) ? 2 : 1;
+    return 2 + (boardWidth + 2) * cellWidth;
+}
+
+int Renderer::cellAt(const Position& p) const {
+    return cells[p.y * boardWidth + p.x];
+}
+
+int Renderer::halfBlockKind(int gx, int gy) const {
+    // The border is part of the pixel grid: (W + 2) x (H + 2) cells
+    const int gridW = boardWidth + 2;
+    const int gridH = boardHeight + 2;
+    if (gy >= gridH) return -1;
+    if (gx == 0 || gy == 0 || gx == gridW - 1 || gy == gridH - 1) return CELL_BORDER;
+    return cells[(gy - 1) * boardWidth + (gx - 1)];
+}
+
+void Renderer::halfBlockCell(int gx, int row, int& fg, int& bg, std::string& out) const {
+    // Two grid rows per terminal line: the upper cell is the foreground of
+    // "▀", the lower one the background; colors are only sent when they change
+    int top = HALFBLOCK_COLORS[halfBlockKind(gx, row * 2)];
+    int bottomKind = halfBlockKind(gx, row * 2 + 1);
+    int bottom = bottomKind < 0 ? -1 : HALFBLOCK_COLORS[bottomKind];
+    if (top == bottom) {
+        // Both halves match: a one-byte space on the background will do
+        if (bg != bottom) {
+            bg = bottom;
+            out += "\033[48;5;" + std::to_string(bg) + "m";
+        }
+        out += ' ';
+        return;
+    }
+    if (bottom != bg) {
+        // Odd grid height: the last line only has an upper half
+        bg = bottom;
+        out += bg < 0 ? std::string("\033[49m") : "\033[48;5;" + std::to_string(bg) + "m";
+    }
+    if (top != fg) {
+        fg = top;
+        out += "\033[38;5;" + std::to_string(fg) + "m";
+    }
+    out += "\xE2\x96\x80"; // U+2580 upper half block
+}
+
+int Renderer::drawBoardText(int bufferY) {
+    const GlyphSet& g = glyphsFor(mode);
+    const std::string pad(2, ' ');
+
+    std::string hBorder = pad + g.corner;
+    for (int i = 0; i < boardWidth; i++) hBorder += g.hBorder;
+    hBorder += g.corner;
+
+    drawToBuffer(0, bufferY++, hBorder);
+    for (int y = 0; y < boardHeight; y++) {
+        std::string line = pad + g.cell[CELL_BORDER];
+        for (int x = 0; x < boardWidth; x++) {
+            line += g.cell[cells[y * boardWidth + x]];
+        }
+        line += g.cell[CELL_BORDER];
+        drawToBuffer(0, bufferY++, line);
+    }
+    drawToBuffer(0, bufferY++, hBorder);
+    return bufferY;
+}
+
+int Renderer::drawBoardHalfBlock(int bufferY) {
+    for (int row = 0; row * 2 < boardHeight + 2; ++row) {
+        std::string line = "  ";
+        int fg = -1, bg = -1;
+        for (int gx = 0; gx < boardWidth + 2; ++gx) {
+            halfBlockCell(gx, row, fg, bg, line);
+        }
+        line += "\033[0m";
+        drawToBuffer(0, bufferY++, line);
+    }
+    return bufferY;
+}
+
+void Renderer::putText(int row, int column, const std::string& text, std::string& out) {
+    out += "\033[" + std::to_string(row + 1) + ";" + std::to_string(column + 1) + "H";
+    out += text;
+    out += "\033[K";
+    // The line no longer matches the last full frame; rewrite it on the next one
+    shownBuffer[row] = std::string(1, '\0');
+}
+
+void Renderer::putCell(const Position& p, int kind, std::string& out) {
+    if (p.x < 0 || p.x >= boardWidth || p.y < 0 || p.y >= boardHeight) return;
+    cells[p.y * boardWidth + p.x] = static_cast<unsigned char>(kind);
+
+    int row, column;
+    std::string glyph;
+    if (mode == RENDER_HALFBLOCK) {
+        int gy = p.y + 1;
+        row = 1 + gy / 2;
+        column = 2 + p.x + 1;
+        int fg = -1, bg = -1;
+        halfBlockCell(p.x + 1, gy / 2, fg, bg, glyph);
+        glyph += "\033[0m";
     } else {
-        // Clear the pause line when not paused
-        drawToBuffer(0, bufferY, pad + "                                                  ");
-    }
-    
-    // Move cursor to top instead of clearing screen (reduces blinking)
-    std::cout << "\033[H";
-    
-    // Output the entire buffer, ensuring we erase leftovers when a line becomes shorter
-    static std::vector<size_t> lastWidths;
-    if (lastWidths.size() != screenBuffer.size()) lastWidths.assign(screenBuffer.size(), 0);
+        row = 2 + p.y;
+        column = 2 + (p.x + 1) * (mode == RENDER_EMOJI ? 2 : 1);
+        glyph = glyphsFor(mode).cell[kind];
+    }
+    out += "\033[" + std::to_string(row + 1) + ";" + std::to_string(column + 1) + "H";
+    out += glyph;
+    shownBuffer[row] = std::string(1, '\0');
+}
+
+void Renderer::onChanges(const std::vector<Change>& changes) {
+    // A paused frame still shows the pause line; let the next full render clear it
+    if (!boardShown || hud.paused) {
+        boardShown = false;
+        return;
+    }
+    TRACE_SCOPE("Renderer::onChanges");
+
+    std::string out;
+    bool titleDirty = false, scoreDirty = false, lengthDirty = false, rareDirty = false, timerDirty = false;
+    for (const auto& change : changes) {
+        switch (change.type) {
+            case CHANGE_RESET:
+                boardShown = false;
+                return;
+            case CHANGE_HEAD_MOVED:
+                putCell(change.pos, CELL_HEAD, out);
+                break;
+            case CHANGE_BODY_ADDED:
+                putCell(change.pos, CELL_BODY, out);
+                break;
+            case CHANGE_TAIL_FREED:
+                putCell(change.pos, CELL_EMPTY, out);
+                break;
+            case CHANGE_FOOD_SPAWNED:
+                if (cellAt(change.pos) == CELL_EMPTY) putCell(change.pos, CELL_FOOD, out);
+                break;
+            case CHANGE_SPECIAL_SPAWNED:
+                hud.specialFoodActive = true;
+                hud.specialFoodTimer = change.value;
+                if (cellAt(change.pos) == CELL_EMPTY) putCell(change.pos, CELL_SPECIAL, out);
+                timerDirty = true;
+                break;
+            case CHANGE_SPECIAL_CLEARED:
+                hud.specialFoodActive = false;
+                hud.specialFoodTimer = 0;
+                if (cellAt(change.pos) == CELL_SPECIAL) putCell(change.pos, CELL_EMPTY, out);
+                timerDirty = true;
+                break;
+            case CHANGE_SPECIAL_TIMER:
+                hud.specialFoodTimer = change.value;
+                timerDirty = true;
+                break;
+            case CHANGE_SCORE:
+                hud.score = change.value;
+                scoreDirty = true;
+                break;
+            case CHANGE_LENGTH:
+                hud.length = change.value;
+                lengthDirty = true;
+                break;
+            case CHANGE_RARE_COUNT:
+                hud.specialFoodCount = change.value;
+                rareDirty = true;
+                break;
+            case CHANGE_HIGH_SCORE:
+                hud.highScore = change.value;
+                titleDirty = true;
+                break;
+            case CHANGE_GAME_OVER:
+                break;
+        }
+    }
+
+    const int footer = 1 + panelLines();
+    if (titleDirty) putText(0, 0, titleLine(), out);
+    if (scoreDirty) putText(sidebarRow(0), sidebarColumn(), sidebarLine(0), out);
+    if (lengthDirty) putText(sidebarRow(1), sidebarColumn(), sidebarLine(1), out);
+    if (rareDirty) putText(sidebarRow(2), sidebarColumn(), sidebarLine(2), out);
+    if (scoreDirty || lengthDirty) putText(footer + FOOTER_SCORE, 0, footerLine(FOOTER_SCORE), out);
+    if (timerDirty) {
+        putText(sidebarRow(9), sidebarColumn(), sidebarLine(9), out);
+        putText(footer + FOOTER_SPECIAL, 0, footerLine(FOOTER_SPECIAL), out);
+        putText(footer + FOOTER_TIMER, 0, footerLine(FOOTER_TIMER), out);
+    }
+
+    if (!out.empty()) {
+        TRACE_SCOPE("Renderer::flush");
+        std::cout << out;
+        std::cout.flush();
+        framesRendered++;
+    }
+}
+
+std::string Renderer::composeFrame(const Snake& snake, const Position& food, const Position& specialFood,
+                                   bool specialFoodActive, const std::vector<Position>& obstacles) {
+    TRACE_SCOPE("Renderer::compose");
+    clearBuffer();
+    fillCells(snake, food, specialFood, specialFoodActive, obstacles);
+
+    std::string frame;
+    if (shownBuffer.empty()) {
+        frame += "\033[2J\033[?25l"; // clear once and hide cursor
+        shownBuffer.assign(screenBuffer.size(), std::string());
+    }
+
+    // Game title with high score, then borders, game board and the right-side
+    // panel aligned with board rows
+    int bufferY = 0;
+    drawToBuffer(0, bufferY++, titleLine());
+    bufferY = (mode == RENDER_HALFBLOCK) ? drawBoardHalfBlock(bufferY) : drawBoardText(bufferY);
+    // The panel goes at the same rows onChanges() patches, below the board if it is short
+    for (int row = 0; row < SIDEBAR_ROWS; ++row) {
+        std::string& line = screenBuffer[sidebarRow(row)];
+        if (line.empty()) line.assign(sidebarColumn(), ' ');
+        line += sidebarLine(row);
+    }
+    bufferY = 1 + panelLines();
+
+    // Footer info, special food indicator + timeline, controls and pause line
+    for (int i = 0; i < FOOTER_LINES; ++i) {
+        drawToBuffer(0, bufferY++, footerLine(i));
+    }
+
+    // Only rewrite lines that differ from what the terminal already shows,
+    // erasing leftovers at the end of each, and write the frame at once
     for (size_t i = 0; i < screenBuffer.size(); ++i) {
-        std::string out = screenBuffer[i];
-        if (lastWidths[i] > out.length()) out.append(lastWidths[i] - out.length(), ' ');
-        std::cout << out << "\n";
-        lastWidths[i] = out.length();
+        if (screenBuffer[i] == shownBuffer[i]) continue;
+        frame += "\033[" + std::to_string(i + 1) + ";1H";
+        frame += screenBuffer[i];
+        frame += "\033[K";
+        shownBuffer[i] = screenBuffer[i];
     }
-    
+    return frame;
+}
+
+void Renderer::render(const Snake& snake, const Position& food, const Position& specialFood,
+                     bool specialFoodActive, int specialFoodTimer, int specialFoodMaxTimer,
+                     int score, int highScore, bool paused,
+                     const std::vector<Position>& obstacles,
+                     int specialFoodCount) {
+    hud.score = score;
+    hud.highScore = highScore;
+    hud.length = snake.getLength();
+    hud.specialFoodCount = specialFoodCount;
+    hud.specialFoodActive = specialFoodActive;
+    hud.specialFoodTimer = specialFoodTimer < 0 ? 0 : specialFoodTimer;
+    hud.specialFoodMaxTimer = specialFoodMaxTimer;
+    hud.paused = paused;
+
+    std::string frame = composeFrame(snake, food, specialFood, specialFoodActive, obstacles);
+    TRACE_SCOPE("Renderer::flush");
+    std::cout << frame;
     std::cout.flush();
+    boardShown = true;
+    framesRendered++;
 }
 
 void Renderer::renderGameOver(int score, int highScore) {
+    const GlyphSet& g = glyphsFor(mode);
     // Clear screen for game over (not every frame)
     clearScreen();
-    std::cout << "\n💀 GAME OVER! 💀\n";
-    std::cout << "🏆 Final Score: " << score << " | High Score: " << highScore << "\n";
-    std::cout << "🔄 Press SPACE or R to return to menu | ❌ Q to quit\n";
+    invalidate();
+    framesRendered++;
+    std::cout << g.gameOver;
+    std::cout << g.finalScore << score << " | High Score: " << highScore << "\n";
+    std::cout << g.gameOverHint;
     std::cout.flush();
 }
 
 void Renderer::renderMenu() {
     clearScreen();
-    std::cout << "🐍 === SNAKE GAME === 🐍\n";
-    std::cout << "1. 🎮 Start Game\n";
-    std::cout << "2. 🏆 Highest Score\n";
-    std::cout << "3. ❌ Exit\n";
-    std::cout << "🎯 Select option: ";
+    invalidate();
+    framesRendered++;
+    std::cout << glyphsFor(mode).menu;
+    std::cout.flush();
+}
+
+void Renderer::renderNamePrompt(const std::string& typed) {
+    clearScreen();
+    invalidate();
+    framesRendered++;
+    std::cout << "Enter your name: " << typed << "\033[?25h"; // show the cursor while typing
+    std::cout.flush();
+}
+
+void Renderer::echoNameChar(char c) {
+    // The prompt stays on screen; only the typed character is written
+    framesRendered++;
+    std::cout << c;
+    std::cout.flush();
+}
+
+void Renderer::eraseNameChar() {
+    framesRendered++;
+    std::cout << "\b \b";
+    std::cout.flush();
+}
+
+void Renderer::restoreTerminal() {
+    std::cout << "\033[?25h\n";
     std::cout.flush();
 }
 
 void Renderer::renderHighScore(const std::string& name, int highScore) {
+    const GlyphSet& g = glyphsFor(mode);
     clearScreen();
-    std::cout << "🏆 Highest Score\n";
-    std::cout << "👤 Player: " << (name.empty() ? std::string("Anonymous") : name) << "\n";
-    std::cout << "📊 Score : " << highScore << "\n\n";
-    std::cout << "↩️  Press any key to return to menu...";
+    invalidate();
+    framesRendered++;
+    std::cout << g.highScoreTitle;
+    std::cout << g.highScorePlayer << (name.empty() ? std::string("Anonymous") : name) << "\n";
+    std::cout << g.highScoreScore << highScore << "\n\n";
+    std::cout << g.highScoreReturn;
     std::cout.flush();
-}
\ No newline at end of file
+}
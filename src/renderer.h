@@ -2,29 +2,101 @@
 #define RENDERER_H
 
 #include "snake.h"
+#include "journal.h"
+#include <cstdint>
 #include <string>
 #include <vector>
 
-class Renderer {
+// Output style. EMOJI is the original look; ASCII and HALFBLOCK trade it for
+// far fewer bytes per frame on serial consoles and slow links.
+enum RenderMode {
+    RENDER_EMOJI,     // two-column emoji cells
+    RENDER_ASCII,     // one byte per cell, plain 7-bit text
+    RENDER_HALFBLOCK  // two board rows per terminal row using 256-color backgrounds
+};
+
+// Pick a render mode from the terminal's advertised capabilities
+RenderMode detectRenderMode();
+bool parseRenderMode(const std::string& name, RenderMode& mode);
+
+// Values shown around the board, kept current from the change journal
+struct HudState {
+    int score;
+    int highScore;
+    int length;
+    int specialFoodCount;
+    bool specialFoodActive;
+    int specialFoodTimer;
+    int specialFoodMaxTimer;
+    bool paused;
+};
+
+// Lines below the board, in screen order
+enum FooterLine { FOOTER_SCORE, FOOTER_SPECIAL, FOOTER_TIMER, FOOTER_CONTROLS, FOOTER_PAUSED, FOOTER_LINES };
+
+// render() draws a full frame; after that onChanges() patches only the
+// cells and panel fields a tick touched.
+class Renderer : public ChangeListener {
 private:
     int boardWidth, boardHeight;
+    RenderMode mode;
     std::vector<std::string> screenBuffer;
-    
+    std::vector<std::string> shownBuffer; // lines currently on the terminal; empty forces a full redraw
+    std::vector<unsigned char> cells; // cell kind on screen, per board cell
+    std::vector<Position> walls; // static level walls, drawn like obstacles
+    HudState hud;
+    bool boardShown; // the game board is on screen and can be patched incrementally
+    uint64_t framesRendered;
+
     void clearBuffer();
     void drawToBuffer(int x, int y, const std::string& content);
-    
+    void fillCells(const Snake& snake, const Position& food, const Position& specialFood,
+                   bool specialFoodActive, const std::vector<Position>& obstacles);
+    std::string titleLine() const;
+    std::string sidebarLine(int row) const;
+    std::string footerLine(int index) const;
+    int boardLines() const;
+    int panelLines() const; // board and side panel, whichever is taller
+    int sidebarRow(int row) const;
+    int sidebarColumn() const;
+    int cellAt(const Position& p) const;
+    int halfBlockKind(int gx, int gy) const;
+    void halfBlockCell(int gx, int row, int& fg, int& bg, std::string& out) const;
+    int drawBoardText(int bufferY);
+    int drawBoardHalfBlock(int bufferY);
+    std::string composeFrame(const Snake& snake, const Position& food, const Position& specialFood,
+                             bool specialFoodActive, const std::vector<Position>& obstacles);
+    void putText(int row, int column, const std::string& text, std::string& out);
+    void putCell(const Position& p, int kind, std::string& out);
+
 public:
-    Renderer(int width, int height);
-    
+    Renderer(int width, int height, RenderMode mode = RENDER_EMOJI);
+
+    RenderMode getMode() const { return mode; }
+    bool isBoardShown() const { return boardShown; }
+    uint64_t getFramesRendered() const { return framesRendered; }
+    // Switch to another board size and set of walls; the next render() redraws everything
+    void setBoard(int width, int height, const std::vector<Position>& levelWalls);
+    // Forget what is on screen so the next render() redraws everything
+    void invalidate() { shownBuffer.clear(); boardShown = false; }
+
     // Updated to include special food
-    void render(const Snake& snake, const Position& food, const Position& specialFood, 
+    void render(const Snake& snake, const Position& food, const Position& specialFood,
                 bool specialFoodActive, int specialFoodTimer, int specialFoodMaxTimer,
                 int score, int highScore, bool paused = false,
                 const std::vector<Position>& obstacles = {},
                 int specialFoodCount = 0);
+    void onChanges(const std::vector<Change>& changes) override;
     void renderGameOver(int score, int highScore);
     void renderMenu();
     void renderHighScore(const std::string& name, int highScore);
+    void renderNamePrompt(const std::string& typed);
+    // Keystrokes on the name prompt, echoed in place after renderNamePrompt()
+    void echoNameChar(char c);
+    void eraseNameChar();
+    // Undo what frames leave behind on the way out: show the cursor again
+    // and end the line so the shell prompt starts on a fresh one
+    void restoreTerminal();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,107 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+#include <random>
+
+// Random engines usable as the game's RNG policy. Each one is a
+// UniformRandomBitGenerator with 32-bit output and an explicit 64-bit seed,
+// so they plug straight into std::uniform_int_distribution.
+
+// std::mt19937: the original engine (about 5 KB of state)
+class Mt19937Rng {
+private:
+    std::mt19937 engine;
+
+public:
+    typedef uint32_t result_type;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    explicit Mt19937Rng(uint64_t seed = 5489u) { this->seed(seed); }
+    void seed(uint64_t seed) {
+        std::seed_seq seq{ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) };
+        engine.seed(seq);
+    }
+    result_type operator()() { return static_cast<result_type>(engine()); }
+};
+
+// PCG32 (XSH-RR 64/32): 16 bytes of state
+class Pcg32Rng {
+private:
+    uint64_t state;
+    uint64_t inc;
+
+public:
+    typedef uint32_t result_type;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    explicit Pcg32Rng(uint64_t seed = 0x853c49e6748fea9bULL) { this->seed(seed); }
+    void seed(uint64_t seed) {
+        state = 0;
+        inc = (seed << 1) | 1u;
+        (*this)();
+        state += seed;
+        (*this)();
+    }
+    result_type operator()() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+    }
+};
+
+// xoshiro128++: 16 bytes of state, seeded through splitmix64
+class Xoshiro128Rng {
+private:
+    uint32_t s[4];
+
+    static uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+public:
+    typedef uint32_t result_type;
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    explicit Xoshiro128Rng(uint64_t seed = 1) { this->seed(seed); }
+    void seed(uint64_t seed) {
+        for (int i = 0; i < 4; i += 2) {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            z ^= z >> 31;
+            s[i] = static_cast<uint32_t>(z);
+            s[i + 1] = static_cast<uint32_t>(z >> 32);
+        }
+    }
+    result_type operator()() {
+        uint32_t result = rotl(s[0] + s[3], 7) + s[0];
+        uint32_t t = s[1] << 9;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 11);
+        return result;
+    }
+};
+
+// Compile-time choice of engine: -DSNAKE_RNG_PCG32 or -DSNAKE_RNG_XOSHIRO
+// for speed and 16-byte state, mt19937 by default for compatibility.
+// SNAKE_RNG_COMPACT is defined when the state is small enough to travel in
+// every CompactGameState.
+#if defined(SNAKE_RNG_PCG32)
+typedef Pcg32Rng GameRng;
+#define SNAKE_RNG_COMPACT
+#elif defined(SNAKE_RNG_XOSHIRO)
+typedef Xoshiro128Rng GameRng;
+#define SNAKE_RNG_COMPACT
+#else
+typedef Mt19937Rng GameRng;
+#endif
+
+#endif
@@ -1,4 +1,5 @@
 #include "snake.h"
+#include "journal.h"
 #include <algorithm>
 
 Snake::Snake(int startX, int startY, int width, int height) 
@@ -7,6 +8,9 @@ Snake::Snake(int startX, int startY, int width, int height)
     direction = RIGHT;
 }
 
+Snake::Snake(const std::deque<Position>& body, Direction direction, int width, int height)
+    : body(body), direction(direction), boardWidth(width), boardHeight(height) {}
+
 void Snake::changeDirection(Direction newDir) {
     // Prevent 180-degree turns
     if ((direction == UP && newDir != DOWN) ||
@@ -17,7 +21,7 @@ void Snake::changeDirection(Direction newDir) {
     }
 }
 
-bool Snake::move() {
+bool Snake::move(ChangeJournal* journal) {
     Position newHead = body.front();
     
     switch (direction) {
@@ -43,8 +47,18 @@ bool Snake::move() {
     // Add new head to front
     body.push_front(newHead);
     // Remove tail
+    Position oldTail = body.back();
     body.pop_back();
     
+    if (journal) {
+        journal->record(CHANGE_HEAD_MOVED, newHead);
+        if (body.size() > 1) journal->record(CHANGE_BODY_ADDED, body[1]);
+        // After grow() the tail is doubled and its cell stays covered
+        if (body.size() == 1 || !(body.back() == oldTail)) {
+            journal->record(CHANGE_TAIL_FREED, oldTail);
+        }
+    }
+    
     return true;
 }
 
@@ -13,6 +13,8 @@ struct Position {
 
 enum Direction { UP, DOWN, LEFT, RIGHT };
 
+class ChangeJournal;
+
 class Snake {
 private:
     std::deque<Position> body;
@@ -21,9 +23,10 @@ private:
 
 public:
     Snake(int startX, int startY, int boardWidth, int boardHeight);
+    Snake(const std::deque<Position>& body, Direction direction, int boardWidth, int boardHeight);
     
     void changeDirection(Direction newDir);
-    bool move();
+    bool move(ChangeJournal* journal = nullptr);
     void grow();
     bool checkCollision() const;
     bool isOnPosition(int x, int y) const;
@@ -31,6 +34,7 @@ public:
     const std::deque<Position>& getBody() const { return body; }
     Position getHead() const { return body.front(); }
     Position getTail() const { return body.back(); }
+    Direction getDirection() const { return direction; }
     int getLength() const { return body.size(); }
 };
 
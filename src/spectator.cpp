@@ -0,0 +1,220 @@
+#include "spectator.h"
+#include <iostream>
+
+#ifndef _WIN32
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+    #include <fcntl.h>
+    #include <signal.h>
+    #include <cerrno>
+    #include <cstring>
+#endif
+
+SpectatorFeed::SpectatorFeed() : listenFd(-1), tickCount(0) {}
+
+SpectatorFeed::~SpectatorFeed() {
+    close();
+}
+
+bool SpectatorFeed::open(const std::string& path) {
+#ifdef _WIN32
+    (void)path;
+    std::cerr << "Spectator feed is not supported on Windows\n";
+    return false;
+#else
+    close();
+
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Spectator socket path too long: " << path << "\n";
+        return false;
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        std::cerr << "Spectator feed: cannot listen on " << path << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return false;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+    // A watcher disconnecting must not kill the game
+    signal(SIGPIPE, SIG_IGN);
+
+    listenFd = fd;
+    socketPath = path;
+    return true;
+#endif
+}
+
+void SpectatorFeed::close() {
+#ifndef _WIN32
+    for (int fd : clients) ::close(fd);
+    for (int fd : pendingClients) ::close(fd);
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        unlink(socketPath.c_str());
+    }
+#endif
+    clients.clear();
+    pendingClients.clear();
+    listenFd = -1;
+}
+
+void SpectatorFeed::acceptClients() {
+#ifndef _WIN32
+    if (listenFd < 0) return;
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) break;
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        pendingClients.push_back(fd);
+    }
+#endif
+}
+
+void SpectatorFeed::putByte(std::vector<unsigned char>& buf, unsigned v) {
+    buf.push_back(static_cast<unsigned char>(v & 0xFF));
+}
+
+void SpectatorFeed::putU16(std::vector<unsigned char>& buf, unsigned v) {
+    putByte(buf, v);
+    putByte(buf, v >> 8);
+}
+
+void SpectatorFeed::putU32(std::vector<unsigned char>& buf, uint32_t v) {
+    putU16(buf, v & 0xFFFF);
+    putU16(buf, v >> 16);
+}
+
+void SpectatorFeed::putPos(std::vector<unsigned char>& buf, const Position& p) {
+    putByte(buf, p.x);
+    putByte(buf, p.y);
+}
+
+void SpectatorFeed::finishFrame(std::vector<unsigned char>& frame) {
+    // Patch the payload length reserved after the kind byte
+    size_t payload = frame.size() - 3;
+    frame[1] = static_cast<unsigned char>(payload & 0xFF);
+    frame[2] = static_cast<unsigned char>((payload >> 8) & 0xFF);
+}
+
+void SpectatorFeed::sendTo(std::vector<int>& targets, const std::vector<unsigned char>& frame) {
+#ifndef _WIN32
+    // Watchers are expected to keep up; a client that would block or fails a
+    // write is dropped rather than letting it stall the game loop.
+    for (size_t i = 0; i < targets.size();) {
+        ssize_t n = send(targets[i], frame.data(), frame.size(), 0);
+        if (n != static_cast<ssize_t>(frame.size())) {
+            ::close(targets[i]);
+            targets.erase(targets.begin() + i);
+        } else {
+            ++i;
+        }
+    }
+#else
+    (void)targets;
+    (void)frame;
+#endif
+}
+
+void SpectatorFeed::onChanges(const std::vector<Change>& changes) {
+    if (clients.empty()) {
+        tickCount++;
+        return;
+    }
+
+    tickBuffer.clear();
+    putByte(tickBuffer, FRAME_TICK);
+    putU16(tickBuffer, 0);
+    putU32(tickBuffer, tickCount++);
+    for (const auto& change : changes) {
+        switch (change.type) {
+            case CHANGE_HEAD_MOVED:
+                putByte(tickBuffer, REC_HEAD_MOVED);
+                putPos(tickBuffer, change.pos);
+                break;
+            case CHANGE_TAIL_FREED:
+                putByte(tickBuffer, REC_TAIL_FREED);
+                putPos(tickBuffer, change.pos);
+                break;
+            case CHANGE_FOOD_SPAWNED:
+                putByte(tickBuffer, REC_FOOD_SPAWNED);
+                putPos(tickBuffer, change.pos);
+                break;
+            case CHANGE_SPECIAL_SPAWNED:
+                putByte(tickBuffer, REC_SPECIAL_SPAWNED);
+                putPos(tickBuffer, change.pos);
+                break;
+            case CHANGE_SPECIAL_CLEARED:
+                putByte(tickBuffer, REC_SPECIAL_CLEARED);
+                break;
+            case CHANGE_SCORE:
+                putByte(tickBuffer, REC_SCORE_CHANGED);
+                putU32(tickBuffer, static_cast<uint32_t>(change.value));
+                break;
+            case CHANGE_GAME_OVER:
+                putByte(tickBuffer, REC_GAME_OVER);
+                break;
+            default:
+                // Body, length and timer changes are implied by the records above;
+                // resets are announced with a keyframe instead
+                break;
+        }
+    }
+    finishFrame(tickBuffer);
+    sendTo(clients, tickBuffer);
+}
+
+void SpectatorFeed::sendKeyframe(int width, int height, const Snake& snake,
+                                 const Position& food, const Position& specialFood, bool specialFoodActive,
+                                 const std::vector<Position>& walls, const std::vector<Position>& obstacles,
+                                 int score, bool toAll) {
+    if (pendingClients.empty() && (!toAll || clients.empty())) return;
+
+    std::vector<unsigned char> frame;
+    putByte(frame, FRAME_KEYFRAME);
+    putU16(frame, 0);
+    putByte(frame, width);
+    putByte(frame, height);
+    putU32(frame, static_cast<uint32_t>(score));
+    putPos(frame, food);
+    putByte(frame, specialFoodActive ? 1 : 0);
+    putPos(frame, specialFood);
+    // Walls can fill most of a large maze, so blocked cells go out as a bitmap
+    const size_t rowBytes = (width + 7) / 8;
+    const size_t bitmap = frame.size();
+    frame.resize(bitmap + rowBytes * height, 0);
+    auto block = [&](const Position& p) {
+        frame[bitmap + p.y * rowBytes + p.x / 8] |= static_cast<unsigned char>(1 << (p.x % 8));
+    };
+    for (const auto& wall : walls) block(wall);
+    for (const auto& ob : obstacles) block(ob);
+    putU16(frame, snake.getBody().size());
+    for (const auto& segment : snake.getBody()) putPos(frame, segment);
+    if (frame.size() - 3 > 0xFFFF) {
+        // A snake this long no longer fits a frame; nobody can be brought up to date
+#ifndef _WIN32
+        for (int fd : pendingClients) ::close(fd);
+        if (toAll) {
+            for (int fd : clients) ::close(fd);
+        }
+#endif
+        pendingClients.clear();
+        if (toAll) clients.clear();
+        return;
+    }
+    finishFrame(frame);
+
+    if (toAll) sendTo(clients, frame);
+    sendTo(pendingClients, frame);
+    clients.insert(clients.end(), pendingClients.begin(), pendingClients.end());
+    pendingClients.clear();
+}
@@ -0,0 +1,81 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include "snake.h"
+#include "journal.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Spectator feed: one running game publishes its per-tick changes on a local
+// Unix socket so any number of watchers can rebuild and draw the board.
+//
+// Wire format (integers little-endian, positions are two bytes: x, y):
+//   frame    := u8 kind, u16 payloadLength, payload
+//   KEYFRAME := u8 width, u8 height, u32 score, pos food,
+//               u8 specialActive, pos specialFood,
+//               u8 blocked[((width + 7) / 8) * height],
+//               u16 snakeLength, pos[snakeLength] (head first)
+//   blocked is a bitmap of level walls and obstacles: bit (x % 8) of
+//   byte y * ((width + 7) / 8) + x / 8
+//   TICK     := u32 tick, record*
+//   record   := u8 type, type-specific data (see SpectatorRecord)
+//
+// Each tick is encoded once and the same bytes are written to every client.
+// New clients receive a keyframe before their first tick.
+enum SpectatorFrame : uint8_t {
+    FRAME_KEYFRAME = 1,
+    FRAME_TICK = 2
+};
+
+enum SpectatorRecord : uint8_t {
+    REC_HEAD_MOVED = 1,       // pos
+    REC_TAIL_FREED = 2,       // pos
+    REC_FOOD_SPAWNED = 3,     // pos
+    REC_SPECIAL_SPAWNED = 4,  // pos
+    REC_SPECIAL_CLEARED = 5,  // no data
+    REC_SCORE_CHANGED = 6,    // u32 score
+    REC_GAME_OVER = 7         // no data
+};
+
+class SpectatorFeed : public ChangeListener {
+private:
+    int listenFd;
+    std::string socketPath;
+    std::vector<int> clients;
+    std::vector<int> pendingClients; // connected, still waiting for a keyframe
+    std::vector<unsigned char> tickBuffer;
+    uint32_t tickCount;
+
+    void putByte(std::vector<unsigned char>& buf, unsigned v);
+    void putU16(std::vector<unsigned char>& buf, unsigned v);
+    void putU32(std::vector<unsigned char>& buf, uint32_t v);
+    void putPos(std::vector<unsigned char>& buf, const Position& p);
+    void sendTo(std::vector<int>& targets, const std::vector<unsigned char>& frame);
+    void finishFrame(std::vector<unsigned char>& frame);
+
+public:
+    SpectatorFeed();
+    ~SpectatorFeed();
+
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return listenFd >= 0; }
+    int getListenFd() const { return listenFd; }
+
+    // Accept any waiting connections (never blocks).
+    void acceptClients();
+    bool hasPendingClients() const { return !pendingClients.empty(); }
+    int getClientCount() const { return static_cast<int>(clients.size() + pendingClients.size()); }
+
+    // Encodes one tick of journal changes and writes it to every client
+    void onChanges(const std::vector<Change>& changes) override;
+
+    // Full board state; sent to pending clients only, or to everyone after a reset.
+    void sendKeyframe(int width, int height, const Snake& snake,
+                      const Position& food, const Position& specialFood, bool specialFoodActive,
+                      const std::vector<Position>& walls, const std::vector<Position>& obstacles,
+                      int score, bool toAll);
+};
+
+#endif
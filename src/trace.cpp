@@ -0,0 +1,66 @@
+#include "trace.h"
+
+#ifdef SNAKE_TRACE
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+    #include <process.h>
+    #define getpid _getpid
+#else
+    #include <unistd.h>
+#endif
+
+// Rings are heap-allocated and never freed so they outlive every thread,
+// including the main thread's thread_local teardown before atexit handlers
+static std::mutex registryMutex;
+static std::vector<TraceRing*> registry;
+
+static void writeTrace() {
+    const char* path = std::getenv("SNAKE_TRACE_FILE");
+    if (!path || !*path) path = "snake_trace.json";
+    FILE* out = std::fopen(path, "w");
+    if (!out) return;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    const int pid = static_cast<int>(getpid());
+    std::fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (TraceRing* ring : registry) {
+        std::fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", pid, ring->threadId, ring->threadId == 0 ? "main" : "worker");
+        first = false;
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = head > TraceRing::CAPACITY ? head - TraceRing::CAPACITY : 0;
+        for (uint64_t i = begin; i < head; ++i) {
+            const TraceEvent& e = ring->events[i % TraceRing::CAPACITY];
+            std::fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         e.name, pid, ring->threadId, e.startNs / 1000.0, e.durationNs / 1000.0);
+        }
+    }
+    std::fprintf(out, "\n]}\n");
+    std::fclose(out);
+}
+
+TraceRing& traceRing() {
+    static thread_local TraceRing* ring = nullptr;
+    if (!ring) {
+        ring = new TraceRing();
+        ring->head.store(0, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(registryMutex);
+        ring->threadId = static_cast<uint32_t>(registry.size());
+        if (registry.empty()) std::atexit(writeTrace);
+        registry.push_back(ring);
+    }
+    return *ring;
+}
+
+uint64_t traceNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Scoped trace events for profiling builds (-DSNAKE_TRACE). Each thread
+// records complete events into its own fixed-size ring; at exit all rings
+// are written as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev)
+// to $SNAKE_TRACE_FILE, or snake_trace.json by default.
+//
+//   void Game::update() {
+//       TRACE_SCOPE("Game::update");
+//       ...
+//
+// Without SNAKE_TRACE the macro expands to nothing.
+
+#ifdef SNAKE_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+struct TraceEvent {
+    const char* name; // string literal, never copied
+    uint64_t startNs;
+    uint64_t durationNs;
+};
+
+// Single-producer ring: only the owning thread writes, and publishes each
+// event by advancing head, so recording never takes a lock. When full the
+// oldest events are overwritten.
+struct TraceRing {
+    static const uint32_t CAPACITY = 1u << 16;
+    TraceEvent events[CAPACITY];
+    std::atomic<uint64_t> head;
+    uint32_t threadId;
+};
+
+TraceRing& traceRing();
+uint64_t traceNowNs();
+
+inline void traceRecord(const char* name, uint64_t startNs, uint64_t endNs) {
+    TraceRing& ring = traceRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    TraceEvent& e = ring.events[head % TraceRing::CAPACITY];
+    e.name = name;
+    e.startNs = startNs;
+    e.durationNs = endNs - startNs;
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+class TraceScope {
+private:
+    const char* name;
+    uint64_t startNs;
+
+public:
+    explicit TraceScope(const char* name) : name(name), startNs(traceNowNs()) {}
+    ~TraceScope() { traceRecord(name, startNs, traceNowNs()); }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+#else
+
+#define TRACE_SCOPE(name)
+
+#endif
+
+#endif
@@ -80,14 +80,21 @@ void getTerminalSize(int& width, int& height) {
 #endif
 }
 
-// Clear screen function
+// Clear screen function: home the cursor, erase the screen and scrollback.
+// Done with escape sequences in-process; no shell is spawned.
 void clearScreen() {
+    std::cout << "\033[H\033[2J\033[3J";
+    std::cout.flush();
+}
+
+// Let the Windows console interpret the escape sequences used for drawing
+void enableVirtualTerminal() {
 #ifdef _WIN32
-    // On Windows, ensure UTF-8 output
-    system("chcp 65001 > nul");
-    system("cls");
-#else
-    system("clear");
+    HANDLE out = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode = 0;
+    if (GetConsoleMode(out, &mode)) {
+        SetConsoleMode(out, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
 #endif
 }
 
@@ -103,6 +110,66 @@ void clearInputBuffer() {
 #endif
 }
 
+#ifndef _WIN32
+static struct termios savedTermios;
+static bool haveSavedTermios = false;
+static int savedInputFlags = 0;
+static bool rawInputActive = false;
+#endif
+
+void enableRawInput() {
+#ifndef _WIN32
+    if (rawInputActive) return;
+    savedInputFlags = fcntl(STDIN_FILENO, F_GETFL, 0);
+    fcntl(STDIN_FILENO, F_SETFL, savedInputFlags | O_NONBLOCK);
+    haveSavedTermios = (tcgetattr(STDIN_FILENO, &savedTermios) == 0);
+    if (haveSavedTermios) {
+        struct termios raw = savedTermios;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    }
+    rawInputActive = true;
+#endif
+}
+
+void restoreInput() {
+#ifndef _WIN32
+    if (!rawInputActive) return;
+    if (haveSavedTermios) tcsetattr(STDIN_FILENO, TCSANOW, &savedTermios);
+    fcntl(STDIN_FILENO, F_SETFL, savedInputFlags);
+    rawInputActive = false;
+#endif
+}
+
+int readAvailableInput(std::deque<int>& keys) {
+#ifdef _WIN32
+    int count = 0;
+    while (_kbhit()) {
+        keys.push_back(_getch());
+        count++;
+    }
+    return count;
+#else
+    // stdin is non-blocking while raw input is enabled
+    unsigned char buf[64];
+    int count = 0;
+    bool eof = false;
+    while (true) {
+        ssize_t n = read(STDIN_FILENO, buf, sizeof(buf));
+        if (n > 0) {
+            keys.insert(keys.end(), buf, buf + n);
+            count += static_cast<int>(n);
+        } else {
+            eof = (n == 0);
+            break;
+        }
+    }
+    return (eof && count == 0) ? -1 : count;
+#endif
+}
+
 // Non-blocking input check with timeout
 int inputWithTimeout(int timeoutMs) {
     auto start = std::chrono::steady_clock::now();
@@ -128,25 +195,25 @@ FrameRateController::FrameRateController(int fps)
     : targetFPS(fps), 
       frameTime(1000.0 / fps),
       lastFrame(std::chrono::steady_clock::now()),
-      fpsStartTime(std::chrono::steady_clock::now()) {}
+      fpsStartTime(std::chrono::steady_clock::now()),
+      lastCounted(fpsStartTime) {}
 
 void FrameRateController::startFrame() {
     lastFrame = std::chrono::steady_clock::now();
 }
 
-void FrameRateController::endFrame() {
-    auto currentTime = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - lastFrame);
-    
-    int sleepTime = static_cast<int>(frameTime) - elapsed.count();
-    
-    if (sleepTime > 0) {
-        highResSleepMs(sleepTime);
-    }
-    
+void FrameRateController::countFrame() {
     // Update FPS calculation every second
-    frameCount++;
     auto now = std::chrono::steady_clock::now();
+    if (now - lastCounted > std::chrono::seconds(1)) {
+        // Back from a pause or a menu: start a new window instead of
+        // counting the frames before it
+        frameCount = 0;
+        currentFPS = 0;
+        fpsStartTime = now;
+    }
+    lastCounted = now;
+    frameCount++;
     auto elapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(now - fpsStartTime).count();
     
     if (elapsedSeconds >= 1) {
@@ -2,6 +2,7 @@
 #define UTILS_H
 
 #include <chrono>
+#include <deque>
 
 #ifdef _WIN32
     #include <windows.h>
@@ -20,9 +21,16 @@ int kbhit();
 int getch();
 void getTerminalSize(int& width, int& height);
 void clearScreen();
+void enableVirtualTerminal();
 void clearInputBuffer();
 int inputWithTimeout(int timeoutMs);
 
+// Keyboard input for the event loop: the terminal stays in non-canonical,
+// no-echo mode between enableRawInput() and restoreInput()
+void enableRawInput();
+void restoreInput();
+int readAvailableInput(std::deque<int>& keys); // appends pending bytes; -1 on EOF
+
 // Frame rate controller class
 class FrameRateController {
 private:
@@ -34,11 +42,12 @@ private:
     int frameCount = 0;
     int currentFPS = 0;
     std::chrono::steady_clock::time_point fpsStartTime;
+    std::chrono::steady_clock::time_point lastCounted;
     
 public:
     FrameRateController(int fps = 60);
     void startFrame();
-    void endFrame();
+    void countFrame(); // FPS bookkeeping only; the event loop's timer paces the ticks
     int getFPS() const;
     
     // Public getter and setter for targetFPS
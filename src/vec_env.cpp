@@ -0,0 +1,232 @@
+#include "vec_env.h"
+#include <cstring>
+#include <random>
+
+VecEnv::VecEnv(int numEnvs, uint64_t seed, const Level& level)
+    : level(level),
+      numEnvs(numEnvs),
+      width(level.getWidth()),
+      height(level.getHeight()),
+      cellCount(level.getWidth() * level.getHeight()),
+      planeBytes((level.getWidth() * level.getHeight() + 7) / 8),
+      bodyCapacity(2 * level.getWidth() * level.getHeight() + 4),
+      deathReward(-1.0f),
+      body(numEnvs * bodyCapacity),
+      headIndex(numEnvs),
+      length(numEnvs),
+      direction(numEnvs),
+      occupancy(numEnvs * cellCount),
+      obstacles(numEnvs * cellCount),
+      food(numEnvs),
+      specialFood(numEnvs),
+      specialFoodActive(numEnvs),
+      specialFoodTimer(numEnvs),
+      score(numEnvs),
+      planes(numEnvs * PLANE_COUNT * planeBytes) {
+    for (const auto& p : level.getFreeCells()) freeCells.push_back(static_cast<uint16_t>(p.y * width + p.x));
+    cellsLeft.reserve(freeCells.size());
+    for (int cell = 0; cell < cellCount; ++cell) {
+        cellX.push_back(static_cast<uint8_t>(cell % width));
+        cellY.push_back(static_cast<uint8_t>(cell / width));
+    }
+    rngs.reserve(numEnvs);
+    for (int env = 0; env < numEnvs; ++env) {
+        rngs.push_back(GameRng(seed + env));
+        reset(env);
+    }
+}
+
+void VecEnv::setBit(int env, int plane, int cell, bool on) {
+    uint8_t& byte = planes[(env * PLANE_COUNT + plane) * planeBytes + cell / 8];
+    uint8_t bit = static_cast<uint8_t>(1 << (cell % 8));
+    byte = on ? (byte | bit) : (byte & ~bit);
+}
+
+void VecEnv::refreshSnakeCell(int env, int cell) {
+    bool head = body[env * bodyCapacity + headIndex[env]] == cell;
+    setBit(env, PLANE_HEAD, cell, head);
+    setBit(env, PLANE_BODY, cell, occupancy[env * cellCount + cell] > (head ? 1 : 0));
+}
+
+void VecEnv::grow(int env) {
+    // Snake::grow(): the tail segment is duplicated
+    uint16_t tail = segment(env, length[env] - 1);
+    segment(env, length[env]) = tail;
+    length[env]++;
+    occupancy[env * cellCount + tail]++;
+    refreshSnakeCell(env, tail);
+}
+
+bool VecEnv::pickFoodCell(int env, int taken, uint16_t& out) {
+    // GameEngine::pickFoodCell(): random cells first, then a pick among what is left
+    const uint16_t* occ = &occupancy[env * cellCount];
+    const uint8_t* obs = &obstacles[env * cellCount];
+    std::uniform_int_distribution<size_t> pick(0, freeCells.size() - 1);
+    for (size_t attempt = 0; attempt < freeCells.size(); ++attempt) {
+        uint16_t cell = freeCells[pick(rngs[env])];
+        if (!occ[cell] && !obs[cell] && cell != taken) {
+            out = cell;
+            return true;
+        }
+    }
+    cellsLeft.clear();
+    for (uint16_t cell : freeCells) {
+        if (!occ[cell] && !obs[cell] && cell != taken) cellsLeft.push_back(cell);
+    }
+    if (cellsLeft.empty()) return false;
+    std::uniform_int_distribution<size_t> pickLeft(0, cellsLeft.size() - 1);
+    out = cellsLeft[pickLeft(rngs[env])];
+    return true;
+}
+
+bool VecEnv::generateFood(int env) {
+    uint16_t cell;
+    if (!pickFoodCell(env, -1, cell)) return false;
+    setBit(env, PLANE_FOOD, food[env], false);
+    food[env] = cell;
+    setBit(env, PLANE_FOOD, cell, true);
+    return true;
+}
+
+void VecEnv::generateSpecialFood(int env) {
+    uint16_t cell;
+    if (!pickFoodCell(env, food[env], cell)) return;
+    specialFood[env] = cell;
+    specialFoodActive[env] = 1;
+    specialFoodTimer[env] = GameEngine::SPECIAL_FOOD_MAX_TIMER;
+    setBit(env, PLANE_SPECIAL, cell, true);
+}
+
+void VecEnv::generateObstacles(int env, int count) {
+    // Same draws and checks as GameEngine::generateObstacles()
+    std::uniform_int_distribution<int> distX(0, width - 1);
+    std::uniform_int_distribution<int> distY(0, height - 1);
+    GameRng& rng = rngs[env];
+    int placed = 0;
+    int attempts = 0;
+    while (placed < count && attempts < count * 20) {
+        int x = distX(rng);
+        int y = distY(rng);
+        Position p(x, y);
+        attempts++;
+        int cell = p.y * width + p.x;
+        if (occupancy[env * cellCount + cell] || level.isWall(p)) continue;
+        if (cell == food[env] || (specialFoodActive[env] && cell == specialFood[env])) continue;
+        if (obstacles[env * cellCount + cell]) continue;
+        obstacles[env * cellCount + cell] = 1;
+        setBit(env, PLANE_BLOCKED, cell, true);
+        placed++;
+    }
+}
+
+void VecEnv::reset(int env) {
+    // GameEngine::reset(): snake, food, then random obstacles
+    std::memset(&occupancy[env * cellCount], 0, cellCount * sizeof(uint16_t));
+    std::memset(&obstacles[env * cellCount], 0, cellCount);
+    std::memset(&planes[env * PLANE_COUNT * planeBytes], 0, PLANE_COUNT * planeBytes);
+    for (const auto& wall : level.getWalls()) setBit(env, PLANE_BLOCKED, wall.y * width + wall.x, true);
+
+    int spawn = 0;
+    if (level.getSpawnCount() > 1) {
+        std::uniform_int_distribution<int> pick(0, level.getSpawnCount() - 1);
+        spawn = pick(rngs[env]);
+    }
+    Position start = level.getSpawn(spawn);
+    uint16_t startCell = static_cast<uint16_t>(start.y * width + start.x);
+    headIndex[env] = 0;
+    length[env] = 1;
+    body[env * bodyCapacity] = startCell;
+    occupancy[env * cellCount + startCell] = 1;
+    direction[env] = static_cast<uint8_t>(level.getSpawnDirection(spawn));
+    refreshSnakeCell(env, startCell);
+
+    score[env] = 0;
+    specialFoodActive[env] = 0;
+    specialFoodTimer[env] = 0;
+    food[env] = startCell;
+    generateFood(env);
+    if (level.isBuiltIn()) {
+        std::uniform_int_distribution<int> obc(5, 7);
+        generateObstacles(env, obc(rngs[env]));
+    }
+}
+
+VecEnv::StepResult VecEnv::stepOne(int env, int action, float& reward) {
+    reward = 0.0f;
+    // Snake::changeDirection(): UP/DOWN and LEFT/RIGHT are pairs differing in bit 0
+    if (action <= RIGHT && action != (direction[env] ^ 1)) direction[env] = static_cast<uint8_t>(action);
+
+    // Snake::move()
+    uint16_t oldHead = segment(env, 0);
+    int x = cellX[oldHead];
+    int y = cellY[oldHead];
+    switch (direction[env]) {
+        case UP:    y--; break;
+        case DOWN:  y++; break;
+        case LEFT:  x--; break;
+        case RIGHT: x++; break;
+    }
+    if (x < 0 || x >= width || y < 0 || y >= height) return STEP_DIED;
+    uint16_t newHead = static_cast<uint16_t>(y * width + x);
+    uint16_t* occ = &occupancy[env * cellCount];
+    if (occ[newHead]) return STEP_DIED;
+
+    headIndex[env] = headIndex[env] == 0 ? bodyCapacity - 1 : headIndex[env] - 1;
+    segment(env, 0) = newHead;
+    occ[newHead]++;
+    uint16_t tail = segment(env, length[env]);
+    occ[tail]--;
+    refreshSnakeCell(env, oldHead);
+    refreshSnakeCell(env, newHead);
+    refreshSnakeCell(env, tail);
+
+    // GameEngine::tick()
+    if (level.isWall(Position(x, y)) || obstacles[env * cellCount + newHead]) return STEP_DIED;
+
+    if (newHead == food[env]) {
+        grow(env);
+        score[env] += 10;
+        reward += 10.0f;
+        if (!generateFood(env)) return STEP_CLEARED;
+        if (score[env] % 30 == 0 && score[env] > 0 && !specialFoodActive[env]) {
+            generateSpecialFood(env);
+        }
+    }
+
+    if (specialFoodActive[env] && newHead == specialFood[env]) {
+        grow(env);
+        score[env] += GameEngine::SPECIAL_FOOD_POINTS;
+        reward += static_cast<float>(GameEngine::SPECIAL_FOOD_POINTS);
+        specialFoodActive[env] = 0;
+        specialFoodTimer[env] = 0;
+        setBit(env, PLANE_SPECIAL, newHead, false);
+        grow(env);
+    }
+
+    if (specialFoodActive[env]) {
+        if (--specialFoodTimer[env] <= 0) {
+            specialFoodActive[env] = 0;
+            specialFoodTimer[env] = 0;
+            setBit(env, PLANE_SPECIAL, specialFood[env], false);
+        }
+    }
+    return STEP_ALIVE;
+}
+
+void VecEnv::observe(uint8_t* observations) const {
+    std::memcpy(observations, planes.data(), planes.size());
+}
+
+void VecEnv::step(const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* dones) {
+    for (int env = 0; env < numEnvs; ++env) {
+        float reward;
+        StepResult result = stepOne(env, actions[env], reward);
+        if (result != STEP_ALIVE) {
+            if (result == STEP_DIED) reward += deathReward;
+            reset(env);
+        }
+        rewards[env] = reward;
+        dones[env] = result == STEP_ALIVE ? 0 : 1;
+    }
+    if (observations) observe(observations);
+}
@@ -0,0 +1,99 @@
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include "engine.h"
+#include "level.h"
+#include "rng.h"
+#include <cstdint>
+#include <vector>
+
+// N independent games stepped in lockstep for bot training, with no
+// terminal, journal or per-step allocation. The rules are those of
+// GameEngine::tick() and Snake::move(), down to the RNG calls: given the same
+// moves, env i deals the same boards in the same order as a Game seeded with
+// seed + i on the same level, starting with its first game:
+//   - a 180-degree turn is ignored; leaving the board, running into any
+//     segment (the tail included, it hasn't moved yet), a wall or an
+//     obstacle ends the episode
+//   - food: +10 and grow (the tail cell is duplicated); special food
+//     spawns when the score hits a multiple of 30 and none is active
+//   - special food: +30 and two segments; its timer starts at 50 and is
+//     decremented every tick including the one it spawned on
+//   - food placement tries random cells, then picks among the cells left;
+//     when none is left the episode ends (without the death reward)
+//
+// Observations are PLANE_COUNT bit planes per env, row-major: bit (c % 8)
+// of byte plane * planeBytes + c / 8 for cell c = y * width + x.
+class VecEnv {
+public:
+    enum Plane { PLANE_HEAD, PLANE_BODY, PLANE_FOOD, PLANE_SPECIAL, PLANE_BLOCKED, PLANE_COUNT };
+
+    // Env i is seeded with seed + i and reset once here
+    VecEnv(int numEnvs, uint64_t seed, const Level& level = Level());
+
+    int size() const { return numEnvs; }
+    int getObservationBytes() const { return PLANE_COUNT * planeBytes; }
+    void setDeathReward(float reward) { deathReward = reward; }
+
+    // Writes numEnvs * getObservationBytes() bytes
+    void observe(uint8_t* observations) const;
+
+    // actions[i] is a Direction (UP, DOWN, LEFT, RIGHT); anything else keeps
+    // going straight. rewards are points scored plus the death reward; a done
+    // env has already been reset and its observation is the new episode's.
+    // observations may be null when the caller reads them separately.
+    void step(const uint8_t* actions, uint8_t* observations, float* rewards, uint8_t* dones);
+
+    int getScore(int env) const { return score[env]; }
+    int getLength(int env) const { return length[env]; }
+
+private:
+    enum StepResult { STEP_ALIVE, STEP_DIED, STEP_CLEARED };
+
+    const Level level;
+    const int numEnvs;
+    const int width, height, cellCount;
+    const int planeBytes;
+    // Ring size. Each growth doubles the tail and each move drops one entry,
+    // so while the snake keeps eating the doubled tail outgrows the board:
+    // every cell once more is a safe bound.
+    const int bodyCapacity;
+    std::vector<uint16_t> freeCells;
+    std::vector<uint8_t> cellX, cellY; // cell index -> coordinates, saves two divisions per step
+    std::vector<uint16_t> cellsLeft;   // scratch for food placement on a crowded board
+    float deathReward;
+
+    // Per-env state, one array per field
+    std::vector<GameRng> rngs;
+    std::vector<uint16_t> body;       // numEnvs rings of bodyCapacity cells
+    std::vector<int> headIndex;       // ring slot of the head
+    std::vector<int> length;
+    std::vector<uint8_t> direction;
+    std::vector<uint16_t> occupancy;  // snake segments per cell (the tail may be doubled)
+    std::vector<uint8_t> obstacles;   // random obstacles per cell
+    std::vector<uint16_t> food;
+    std::vector<uint16_t> specialFood;
+    std::vector<uint8_t> specialFoodActive;
+    std::vector<int> specialFoodTimer;
+    std::vector<int> score;
+    std::vector<uint8_t> planes;      // current observation per env
+
+    uint16_t& segment(int env, int i) {
+        int slot = headIndex[env] + i;
+        if (slot >= bodyCapacity) slot -= bodyCapacity;
+        return body[env * bodyCapacity + slot];
+    }
+    void setBit(int env, int plane, int cell, bool on);
+    void refreshSnakeCell(int env, int cell);
+    void grow(int env);
+    // taken is a cell to keep clear as well, or -1
+    bool pickFoodCell(int env, int taken, uint16_t& out);
+    bool generateFood(int env);
+    void generateSpecialFood(int env);
+    void generateObstacles(int env, int count);
+    void reset(int env);
+    // Advances one env
+    StepResult stepOne(int env, int action, float& reward);
+};
+
+#endif
@@ -0,0 +1,644 @@
+// Differential fuzzer for the game rules: random levels, seeds and action
+// streams are played through GameEngine (the code Game runs), VecEnv and a
+// plain reference model of the rules (std::deque body, linear scans, no
+// Snake class). The engine's state and VecEnv's observations, rewards and
+// dones are compared with the reference every tick; the first divergence is
+// printed with board dumps and the command line that replays the case. Tiny
+// boards and a food-seeking policy make the snake fill the board, which
+// covers the crowded-board food placement paths. Random byte images are also
+// fed to Level::fromBytes(). Every tick the engine's snapshot is restored
+// into a second engine and taken again, and a corrupted copy must be
+// rejected by GameEngine::restore().
+// Build: g++ -std=c++11 -O2 -Isrc tools/snake_fuzz.cpp src/engine.cpp src/vec_env.cpp src/level.cpp src/snake.cpp src/journal.cpp -o snake_fuzz
+//        (add -fsanitize=address,undefined -g to catch memory errors as well)
+// Usage: snake_fuzz [-t SECONDS] [-n CASES] [-s SEED] [-c CASE]
+#include "engine.h"
+#include "journal.h"
+#include "level.h"
+#include "vec_env.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct Options {
+    double seconds = 10;
+    long cases = -1;      // unlimited unless given
+    uint64_t seed = 0;
+    bool seedGiven = false;
+    long onlyCase = -1;   // replay a single case
+};
+
+struct Stats {
+    uint64_t ticks = 0;
+    uint64_t episodes = 0;
+    uint64_t deaths = 0;
+    uint64_t cleared = 0;         // episodes that ended with the board full
+    uint64_t fallbackPicks = 0;   // food placed by the scan after random misses
+    uint64_t specialDenied = 0;   // special food due but no cell left for it
+    uint64_t levelImages = 0;
+    uint64_t snapshots = 0;        // snapshot/restore round trips
+    uint64_t corruptAccepted = 0;  // randomly damaged snapshots that were still valid
+    uint64_t resumedPickups = 0;   // restored games followed through a food pickup
+};
+
+enum Policy { POLICY_RANDOM, POLICY_FOOD, POLICY_STRAIGHT, POLICY_COUNT };
+
+enum Outcome { OUTCOME_ALIVE, OUTCOME_DIED, OUTCOME_CLEARED };
+
+// The rules, written for clarity rather than speed
+class ReferenceGame {
+public:
+    ReferenceGame(const Level& level, uint64_t seed, Stats& stats) : level(level), rng(seed), stats(stats) {
+        reset();
+    }
+
+    const std::deque<Position>& getBody() const { return body; }
+    Direction getDirection() const { return direction; }
+    const Position& getFood() const { return food; }
+    bool isSpecialActive() const { return specialActive; }
+    const Position& getSpecialFood() const { return specialFood; }
+    int getSpecialTimer() const { return specialTimer; }
+    const std::vector<Position>& getObstacles() const { return obstacles; }
+    int getScore() const { return score; }
+    int getSpecialCount() const { return specialCount; }
+
+    bool isBlocked(const Position& p) const {
+        if (p.x < 0 || p.x >= level.getWidth() || p.y < 0 || p.y >= level.getHeight()) return true;
+        return level.isWall(p) || contains(obstacles, p) || contains(body, p);
+    }
+
+    void reset() {
+        int spawn = 0;
+        if (level.getSpawnCount() > 1) {
+            std::uniform_int_distribution<int> pick(0, level.getSpawnCount() - 1);
+            spawn = pick(rng);
+        }
+        Position start = level.getSpawn(spawn);
+        direction = level.getSpawnDirection(spawn);
+        body.assign(1, start);
+        score = 0;
+        specialCount = 0;
+        specialActive = false;
+        specialTimer = 0;
+        obstacles.clear();
+        food = start;
+        placeFood(food, nullptr);
+        if (level.isBuiltIn()) {
+            std::uniform_int_distribution<int> obc(5, 7);
+            int count = obc(rng);
+            std::uniform_int_distribution<int> distX(0, level.getWidth() - 1);
+            std::uniform_int_distribution<int> distY(0, level.getHeight() - 1);
+            for (int attempts = 0; static_cast<int>(obstacles.size()) < count && attempts < count * 20; ++attempts) {
+                int x = distX(rng);
+                int y = distY(rng);
+                Position p(x, y);
+                if (contains(body, p) || level.isWall(p) || p == food || contains(obstacles, p)) continue;
+                obstacles.push_back(p);
+            }
+        }
+    }
+
+    Outcome step(int action, float& reward) {
+        reward = 0;
+        if (action <= RIGHT) {
+            Direction wanted = static_cast<Direction>(action);
+            bool reverse = (direction == UP && wanted == DOWN) || (direction == DOWN && wanted == UP) ||
+                           (direction == LEFT && wanted == RIGHT) || (direction == RIGHT && wanted == LEFT);
+            if (!reverse) direction = wanted;
+        }
+
+        Position head = body.front();
+        if (direction == UP) head.y--;
+        else if (direction == DOWN) head.y++;
+        else if (direction == LEFT) head.x--;
+        else head.x++;
+        // The tail has not moved yet, so running into it is fatal too
+        if (head.x < 0 || head.x >= level.getWidth() || head.y < 0 || head.y >= level.getHeight() ||
+            contains(body, head)) {
+            return OUTCOME_DIED;
+        }
+        body.push_front(head);
+        body.pop_back();
+        if (level.isWall(head) || contains(obstacles, head)) return OUTCOME_DIED;
+
+        if (head == food) {
+            grow();
+            score += 10;
+            reward += 10;
+            if (!placeFood(food, nullptr)) return OUTCOME_CLEARED;
+            if (score % 30 == 0 && !specialActive) {
+                if (placeFood(specialFood, &food)) {
+                    specialActive = true;
+                    specialTimer = 50;
+                } else {
+                    stats.specialDenied++;
+                }
+            }
+        }
+        if (specialActive && head == specialFood) {
+            grow();
+            grow();
+            score += 30;
+            reward += 30;
+            specialCount++;
+            specialActive = false;
+            specialTimer = 0;
+        }
+        if (specialActive && --specialTimer <= 0) {
+            specialActive = false;
+            specialTimer = 0;
+        }
+        return OUTCOME_ALIVE;
+    }
+
+private:
+    const Level& level;
+    GameRng rng;
+    Stats& stats;
+    std::deque<Position> body;
+    Direction direction;
+    Position food, specialFood;
+    bool specialActive;
+    int specialTimer;
+    int score;
+    int specialCount;
+    std::vector<Position> obstacles;
+
+    template <typename Container>
+    static bool contains(const Container& cells, const Position& p) {
+        return std::find(cells.begin(), cells.end(), p) != cells.end();
+    }
+
+    void grow() {
+        body.push_back(body.back());
+    }
+
+    bool canHoldFood(const Position& p, const Position* taken) const {
+        return !contains(body, p) && !contains(obstacles, p) && !(taken && p == *taken);
+    }
+
+    bool placeFood(Position& out, const Position* taken) {
+        const std::vector<Position>& cells = level.getFreeCells();
+        std::uniform_int_distribution<size_t> pick(0, cells.size() - 1);
+        for (size_t attempt = 0; attempt < cells.size(); ++attempt) {
+            Position p = cells[pick(rng)];
+            if (canHoldFood(p, taken)) {
+                out = p;
+                return true;
+            }
+        }
+        std::vector<Position> left;
+        for (const auto& p : cells) {
+            if (canHoldFood(p, taken)) left.push_back(p);
+        }
+        if (left.empty()) return false;
+        stats.fallbackPicks++;
+        std::uniform_int_distribution<size_t> pickLeft(0, left.size() - 1);
+        out = left[pickLeft(rng)];
+        return true;
+    }
+};
+
+static void putBits(std::vector<unsigned char>& bytes, size_t offset, int width, int x, int y) {
+    bytes[offset + y * ((width + 7) / 8) + x / 8] |= static_cast<unsigned char>(1 << (x % 8));
+}
+
+// A random level image: dimensions, wall and exclusion density, spawns
+static std::vector<unsigned char> randomLevelImage(std::mt19937_64& gen) {
+    std::uniform_int_distribution<int> side(2, 24);
+    std::uniform_int_distribution<int> small(2, 5);
+    bool tiny = gen() % 2 == 0;
+    int width = tiny ? small(gen) : side(gen);
+    int height = tiny ? small(gen) : side(gen);
+    double wallDensity = std::uniform_real_distribution<double>(0.0, 0.35)(gen);
+    double exclusionDensity = std::uniform_real_distribution<double>(0.0, 0.15)(gen);
+    std::uniform_real_distribution<double> roll(0.0, 1.0);
+
+    std::vector<char> cells(width * height, '.');
+    for (auto& c : cells) {
+        double r = roll(gen);
+        if (r < wallDensity) c = '#';
+        else if (r < wallDensity + exclusionDensity) c = '~';
+    }
+    std::vector<int> open;
+    for (int i = 0; i < width * height; ++i) {
+        if (cells[i] != '#') open.push_back(i);
+    }
+    std::vector<LevelSpawn> spawns;
+    if (!open.empty()) {
+        int count = 1 + static_cast<int>(gen() % 4);
+        for (int i = 0; i < count; ++i) {
+            int cell = open[gen() % open.size()];
+            LevelSpawn s = { static_cast<uint8_t>(cell % width), static_cast<uint8_t>(cell / width),
+                             static_cast<uint8_t>(gen() % 4), 0 };
+            spawns.push_back(s);
+        }
+    }
+
+    const size_t bitmapBytes = static_cast<size_t>((width + 7) / 8) * height;
+    std::vector<unsigned char> image(sizeof(LevelFileHeader) + 2 * bitmapBytes + spawns.size() * sizeof(LevelSpawn), 0);
+    const size_t walls = sizeof(LevelFileHeader);
+    for (int i = 0; i < width * height; ++i) {
+        if (cells[i] == '#') putBits(image, walls, width, i % width, i / width);
+        if (cells[i] == '~') putBits(image, walls + bitmapBytes, width, i % width, i / width);
+    }
+    if (!spawns.empty()) {
+        std::memcpy(&image[walls + 2 * bitmapBytes], spawns.data(), spawns.size() * sizeof(LevelSpawn));
+    }
+    LevelFileHeader header;
+    header.magic = LEVEL_MAGIC;
+    header.version = LEVEL_VERSION;
+    header.width = static_cast<uint16_t>(width);
+    header.height = static_cast<uint16_t>(height);
+    header.spawnCount = static_cast<uint16_t>(spawns.size());
+    header.payloadSize = static_cast<uint32_t>(image.size() - sizeof(header));
+    header.checksum = levelChecksum(&image[walls], header.payloadSize);
+    std::memcpy(&image[0], &header, sizeof(header));
+    return image;
+}
+
+// Truncated and bit-flipped images must be rejected or loaded, never crash
+static void fuzzLevelLoader(std::vector<unsigned char> image, std::mt19937_64& gen, Stats& stats) {
+    std::streambuf* saved = std::cerr.rdbuf(nullptr);
+    for (int i = 0; i < 8 && !image.empty(); ++i) {
+        std::vector<unsigned char> mutated = image;
+        switch (gen() % 3) {
+            case 0: mutated.resize(gen() % mutated.size()); break;
+            case 1: mutated[gen() % mutated.size()] ^= static_cast<unsigned char>(1 << (gen() % 8)); break;
+            default: mutated.push_back(static_cast<unsigned char>(gen())); break;
+        }
+        Level level;
+        if (level.fromBytes(mutated.data(), mutated.size(), "mutated")) {
+            // Whatever got through must still be self-consistent
+            for (const auto& p : level.getFreeCells()) {
+                if (!level.allowsFood(p)) std::abort();
+            }
+        }
+        stats.levelImages++;
+    }
+    std::cerr.rdbuf(saved);
+}
+
+static int chooseAction(Policy policy, const ReferenceGame& game, std::mt19937_64& gen) {
+    if (policy == POLICY_RANDOM) return static_cast<int>(gen() % 6); // 4 and 5 keep going straight
+    if (policy == POLICY_STRAIGHT) return gen() % 8 == 0 ? static_cast<int>(gen() % 4) : 4;
+
+    // Head for the food over cells that are not immediately fatal
+    Position head = game.getBody().front();
+    Position target = game.isSpecialActive() ? game.getSpecialFood() : game.getFood();
+    int best = -1;
+    int bestDistance = 0;
+    for (int dir = UP; dir <= RIGHT; ++dir) {
+        Position next = head;
+        if (dir == UP) next.y--;
+        else if (dir == DOWN) next.y++;
+        else if (dir == LEFT) next.x--;
+        else next.x++;
+        // The tail cell frees up unless the snake is about to grow
+        bool tail = next == game.getBody().back() && game.getBody().size() > 1 && !(next == target);
+        if (game.isBlocked(next) && !tail) continue;
+        int distance = std::abs(next.x - target.x) + std::abs(next.y - target.y) + static_cast<int>(gen() % 2);
+        if (best < 0 || distance < bestDistance) {
+            best = dir;
+            bestDistance = distance;
+        }
+    }
+    return best < 0 ? 4 : best;
+}
+
+static char referenceCell(const Level& level, const ReferenceGame& game, const Position& p) {
+    const std::vector<Position>& obstacles = game.getObstacles();
+    const std::deque<Position>& body = game.getBody();
+    char c = '.';
+    if (level.isWall(p) || std::find(obstacles.begin(), obstacles.end(), p) != obstacles.end()) c = '#';
+    if (std::find(body.begin(), body.end(), p) != body.end()) c = 'o';
+    if (body.front() == p) c = '@';
+    if (game.getFood() == p && c == '.') c = '*';
+    if (game.isSpecialActive() && game.getSpecialFood() == p) c = '$';
+    return c;
+}
+
+static char engineCell(const GameEngine& engine, const Position& p) {
+    const std::vector<Position>& obstacles = engine.getObstacles();
+    char c = '.';
+    if (engine.getLevel().isWall(p) || std::find(obstacles.begin(), obstacles.end(), p) != obstacles.end()) c = '#';
+    if (engine.getSnake().isOnPosition(p.x, p.y)) c = 'o';
+    if (engine.getSnake().getHead() == p) c = '@';
+    if (engine.getFood() == p && c == '.') c = '*';
+    if (engine.isSpecialFoodActive() && engine.getSpecialFood() == p) c = '$';
+    return c;
+}
+
+static char planeCell(const uint8_t* planes, int planeBytes, int cell) {
+    auto bit = [&](int plane) { return (planes[plane * planeBytes + cell / 8] >> (cell % 8)) & 1; };
+    char c = '.';
+    if (bit(VecEnv::PLANE_BLOCKED)) c = '#';
+    if (bit(VecEnv::PLANE_BODY)) c = 'o';
+    if (bit(VecEnv::PLANE_HEAD)) c = '@';
+    if (bit(VecEnv::PLANE_FOOD) && c == '.') c = '*';
+    if (bit(VecEnv::PLANE_SPECIAL)) c = '$';
+    return c;
+}
+
+static std::string dumpBoards(const Level& level, const ReferenceGame& game, const GameEngine& engine,
+                              const uint8_t* planes, int planeBytes) {
+    std::ostringstream out;
+    const int width = level.getWidth();
+    const std::string gap(width > 9 ? width - 7 : 2, ' ');
+    out << "  reference" << gap << "engine" << std::string(width > 6 ? width - 4 : 2, ' ') << "vec_env\n";
+    for (int y = 0; y < level.getHeight(); ++y) {
+        std::string expected, fromEngine, fromPlanes;
+        for (int x = 0; x < width; ++x) {
+            expected += referenceCell(level, game, Position(x, y));
+            fromEngine += engineCell(engine, Position(x, y));
+            fromPlanes += planeCell(planes, planeBytes, y * width + x);
+        }
+        out << "  " << expected << std::string(width < 9 ? 11 - width : 2, ' ') << fromEngine
+            << std::string(width < 6 ? 8 - width : 2, ' ') << fromPlanes << "\n";
+    }
+    return out.str();
+}
+
+// Where GameEngine's state first differs from the reference, or empty
+static std::string compareEngine(const GameEngine& engine, const ReferenceGame& game) {
+    const std::deque<Position>& body = engine.getSnake().getBody();
+    if (body != game.getBody()) return "engine snake differs";
+    if (engine.getSnake().getDirection() != game.getDirection()) return "engine direction differs";
+    if (!(engine.getFood() == game.getFood())) return "engine food differs";
+    if (engine.isSpecialFoodActive() != game.isSpecialActive()) return "engine special food state differs";
+    if (game.isSpecialActive() && (!(engine.getSpecialFood() == game.getSpecialFood()) ||
+                                   engine.getSpecialFoodTimer() != game.getSpecialTimer())) {
+        return "engine special food differs";
+    }
+    if (engine.getObstacles() != game.getObstacles()) return "engine obstacles differ";
+    if (engine.getScore() != game.getScore()) return "engine score differs";
+    if (engine.getSpecialFoodCount() != game.getSpecialCount()) return "engine special food count differs";
+    return std::string();
+}
+
+// Observation planes the reference state should produce
+static void expectedPlanes(const Level& level, const ReferenceGame& game, std::vector<uint8_t>& planes, int planeBytes) {
+    std::fill(planes.begin(), planes.end(), 0);
+    const int width = level.getWidth();
+    auto set = [&](int plane, const Position& p) {
+        int cell = p.y * width + p.x;
+        planes[plane * planeBytes + cell / 8] |= static_cast<uint8_t>(1 << (cell % 8));
+    };
+    const std::deque<Position>& body = game.getBody();
+    set(VecEnv::PLANE_HEAD, body.front());
+    // A one-cell snake that just ate has its doubled tail under the head
+    for (size_t i = 1; i < body.size(); ++i) set(VecEnv::PLANE_BODY, body[i]);
+    set(VecEnv::PLANE_FOOD, game.getFood());
+    if (game.isSpecialActive()) set(VecEnv::PLANE_SPECIAL, game.getSpecialFood());
+    for (const auto& p : level.getWalls()) set(VecEnv::PLANE_BLOCKED, p);
+    for (const auto& p : game.getObstacles()) set(VecEnv::PLANE_BLOCKED, p);
+}
+
+// A restored game must go on exactly like the original: both are steered to
+// the food with the same moves and must place the next food on the same cell
+static std::string checkResume(const GameEngine& engine, GameEngine& restored, Stats& stats) {
+    GameEngine original = engine;
+    const int limit = 2 * original.getLevel().getWidth() * original.getLevel().getHeight();
+    for (int step = 0; step < limit; ++step) {
+        Position head = original.getSnake().getHead();
+        Position food = original.getFood();
+        Direction dir = original.getSnake().getDirection();
+        if (food.x != head.x) dir = food.x < head.x ? LEFT : RIGHT;
+        else if (food.y != head.y) dir = food.y < head.y ? UP : DOWN;
+        original.changeDirection(dir);
+        restored.changeDirection(dir);
+        int score = original.getScore();
+        TickResult result = original.tick();
+        if (restored.tick() != result) return "restored game ended differently";
+        if (result != TICK_ALIVE) return std::string();
+        if (!(restored.getFood() == original.getFood()) || restored.getScore() != original.getScore() ||
+            restored.isSpecialFoodActive() != original.isSpecialFoodActive() ||
+            (original.isSpecialFoodActive() && !(restored.getSpecialFood() == original.getSpecialFood()))) {
+            return "restored game placed food differently";
+        }
+        if (original.getScore() != score) {
+            stats.resumedPickups++;
+            return std::string();
+        }
+    }
+    return std::string();
+}
+
+// snapshot() -> restore() -> snapshot() must give the same bytes; a snapshot
+// with a field out of range must be rejected without touching the engine,
+// and one with a random flipped bit must be rejected or be safe to play on
+static std::string checkSnapshot(const GameEngine& engine, GameEngine& scratch, std::mt19937_64& gen, Stats& stats) {
+    const Level& level = engine.getLevel();
+    CompactGameState taken, again;
+    if (!engine.snapshot(taken)) {
+        if (engine.getSnake().getLength() <= COMPACT_MAX_LENGTH &&
+            static_cast<int>(engine.getObstacles().size()) <= COMPACT_MAX_OBSTACLES) return "snapshot() failed";
+        return std::string();
+    }
+    if (!scratch.restore(taken, level)) return "restore() rejected a fresh snapshot";
+    if (!scratch.snapshot(again) || std::memcmp(&taken, &again, sizeof(taken)) != 0) return "snapshot round trip differs";
+    stats.snapshots++;
+
+    CompactGameState bad = taken;
+    const int width = level.getWidth();
+    const PackedPos offBoard = packPos(Position(width + static_cast<int>(gen() % (256 - width)), 0));
+    const char* field = nullptr;
+    switch (gen() % 9) {
+        case 0: bad.length = 0; field = "length 0"; break;
+        case 1: bad.length = COMPACT_MAX_LENGTH + 1; field = "oversized length"; break;
+        case 2: bad.direction = static_cast<uint8_t>(4 + gen() % 252); field = "direction"; break;
+        case 3: bad.body[gen() % bad.length] = offBoard; field = "body cell off the board"; break;
+        case 4: bad.obstacleCount = COMPACT_MAX_OBSTACLES + 1; field = "obstacle count"; break;
+        case 5: bad.food = offBoard; field = "food off the board"; break;
+        case 6: bad.specialFoodTimer = gen() % 2 ? -1 : GameEngine::SPECIAL_FOOD_MAX_TIMER + 1; field = "special timer"; break;
+        case 7: bad.levelChecksum ^= 1u << (gen() % 32); field = "level checksum"; break;
+        default: {
+            // Any byte in use, some of which may still leave a valid state
+            size_t used = offsetof(CompactGameState, body) + bad.length * sizeof(PackedPos);
+            reinterpret_cast<unsigned char*>(&bad)[gen() % used] ^= static_cast<unsigned char>(1 << (gen() % 8));
+            break;
+        }
+    }
+    if (scratch.restore(bad, level)) {
+        if (field) return std::string("restore() accepted a snapshot with a bad ") + field;
+        stats.corruptAccepted++;
+        scratch.tick();
+    } else if (!scratch.snapshot(again) || std::memcmp(&taken, &again, sizeof(taken)) != 0) {
+        return "a rejected restore() changed the engine";
+    }
+
+    // Playing on copies the engine, so only now and then
+    if (gen() % 8 != 0) return std::string();
+    scratch.restore(taken, level);
+#ifndef SNAKE_RNG_COMPACT
+    scratch.setRng(engine.getRng()); // not in the snapshot
+#endif
+    return checkResume(engine, scratch, stats);
+}
+
+// Plays one random case; prints the divergence and returns false on a mismatch
+static bool runCase(uint64_t caseSeed, const Options& opt, long caseIndex, Stats& stats) {
+    std::mt19937_64 gen(caseSeed);
+    Level level;
+    std::string description;
+    if (gen() % 4 == 0) {
+        // Built-in board: open field plus random obstacles
+        std::uniform_int_distribution<int> side(2, 40);
+        level = Level(side(gen), side(gen));
+        description = "built-in";
+    } else {
+        std::vector<unsigned char> image = randomLevelImage(gen);
+        fuzzLevelLoader(image, gen, stats);
+        std::streambuf* saved = std::cerr.rdbuf(nullptr);
+        bool loaded = level.fromBytes(image.data(), image.size(), "generated");
+        std::cerr.rdbuf(saved);
+        // Too few food cells or no spawn: rejecting it is correct
+        if (!loaded) return true;
+        description = "generated";
+    }
+
+    const int envs = 1 + static_cast<int>(gen() % 8);
+    const int ticks = 200 + static_cast<int>(gen() % 2000);
+    const uint64_t envSeed = gen();
+    VecEnv vec(envs, envSeed, level);
+    std::vector<ReferenceGame> games;
+    std::vector<GameEngine> engines;
+    std::vector<Policy> policies;
+    games.reserve(envs);
+    for (int i = 0; i < envs; ++i) {
+        games.push_back(ReferenceGame(level, envSeed + i, stats));
+        engines.push_back(GameEngine(level, envSeed + i));
+        engines.back().reset();
+        policies.push_back(static_cast<Policy>(gen() % POLICY_COUNT));
+    }
+    ChangeJournal journal; // no subscribers; exercises the engine's journal path
+    GameEngine scratch(level, 0); // restores snapshots of the others
+
+    const int obsBytes = vec.getObservationBytes();
+    const int planeBytes = obsBytes / VecEnv::PLANE_COUNT;
+    std::vector<uint8_t> actions(envs), dones(envs), observations(static_cast<size_t>(envs) * obsBytes);
+    std::vector<uint8_t> expected(obsBytes);
+    std::vector<float> rewards(envs);
+    vec.observe(observations.data());
+
+    for (int tick = 0; tick <= ticks; ++tick) {
+        for (int i = 0; i < envs; ++i) {
+            const ReferenceGame& game = games[i];
+            const uint8_t* planes = &observations[static_cast<size_t>(i) * obsBytes];
+            expectedPlanes(level, game, expected, planeBytes);
+            std::string error = compareEngine(engines[i], game);
+            if (error.empty()) error = checkSnapshot(engines[i], scratch, gen, stats);
+            if (error.empty()) {
+                if (std::memcmp(expected.data(), planes, obsBytes) != 0) error = "vec_env observation planes differ";
+                else if (vec.getScore(i) != game.getScore()) error = "vec_env score differs";
+                else if (vec.getLength(i) != static_cast<int>(game.getBody().size())) error = "vec_env length differs";
+            }
+            if (!error.empty()) {
+                std::cout << "MISMATCH case " << caseIndex << " (" << description << " " << level.getWidth() << "x"
+                          << level.getHeight() << ", " << envs << " envs) env " << i << " tick " << tick << ": " << error
+                          << "\n  score " << game.getScore() << " / " << engines[i].getScore() << " / " << vec.getScore(i)
+                          << ", length " << game.getBody().size() << " / " << engines[i].getSnake().getLength()
+                          << " / " << vec.getLength(i) << "\n"
+                          << dumpBoards(level, game, engines[i], planes, planeBytes)
+                          << "Replay: snake_fuzz -s " << opt.seed << " -c " << caseIndex << "\n";
+                return false;
+            }
+        }
+        if (tick == ticks) break;
+
+        for (int i = 0; i < envs; ++i) actions[i] = static_cast<uint8_t>(chooseAction(policies[i], games[i], gen));
+        vec.step(actions.data(), observations.data(), rewards.data(), dones.data());
+        for (int i = 0; i < envs; ++i) {
+            float reward;
+            Outcome outcome = games[i].step(actions[i], reward);
+            if (outcome == OUTCOME_DIED) reward -= 1.0f;
+            bool done = outcome != OUTCOME_ALIVE;
+
+            if (actions[i] <= RIGHT) engines[i].changeDirection(static_cast<Direction>(actions[i]));
+            TickResult result = engines[i].tick(&journal);
+            journal.commit();
+            const TickResult expectedResult = outcome == OUTCOME_ALIVE ? TICK_ALIVE :
+                                              outcome == OUTCOME_DIED ? TICK_DIED : TICK_CLEARED;
+
+            if (done) {
+                stats.episodes++;
+                if (outcome == OUTCOME_DIED) stats.deaths++;
+                else stats.cleared++;
+                games[i].reset();
+                engines[i].reset();
+            }
+            if (result != expectedResult || (dones[i] != 0) != done || rewards[i] != reward) {
+                std::cout << "MISMATCH case " << caseIndex << " (" << description << " " << level.getWidth() << "x"
+                          << level.getHeight() << ", " << envs << " envs) env " << i << " tick " << tick
+                          << ": outcome " << outcome << " / " << result << " / done " << int(dones[i])
+                          << ", reward " << reward << " / " << rewards[i]
+                          << "\nReplay: snake_fuzz -s " << opt.seed << " -c " << caseIndex << "\n";
+                return false;
+            }
+        }
+        stats.ticks += envs;
+    }
+    return true;
+}
+
+static bool parseOptions(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        if (arg == "-t") opt.seconds = std::atof(argv[++i]);
+        else if (arg == "-n") opt.cases = std::atol(argv[++i]);
+        else if (arg == "-s") { opt.seed = std::strtoull(argv[++i], nullptr, 10); opt.seedGiven = true; }
+        else if (arg == "-c") opt.onlyCase = std::atol(argv[++i]);
+        else return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0] << " [-t SECONDS] [-n CASES] [-s SEED] [-c CASE]\n";
+        return 2;
+    }
+    if (!opt.seedGiven) {
+        opt.seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+    std::cout << "seed " << opt.seed << "\n";
+
+    Stats stats;
+    auto start = std::chrono::steady_clock::now();
+    long index = opt.onlyCase >= 0 ? opt.onlyCase : 0;
+    long run = 0;
+    for (;; ++index, ++run) {
+        if (opt.onlyCase >= 0 ? run == 1 : opt.cases >= 0 ? run == opt.cases :
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() >= opt.seconds) break;
+        // Cases are seeded independently so any one of them can be replayed
+        std::seed_seq seq{ static_cast<uint32_t>(opt.seed), static_cast<uint32_t>(opt.seed >> 32),
+                           static_cast<uint32_t>(index) };
+        uint32_t words[2];
+        seq.generate(words, words + 2);
+        if (!runCase((static_cast<uint64_t>(words[0]) << 32) | words[1], opt, index, stats)) return 1;
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%ld cases, %llu ticks (%.2f M/s), %llu episodes: %llu deaths, %llu full boards\n",
+                run, static_cast<unsigned long long>(stats.ticks), stats.ticks / seconds / 1e6,
+                static_cast<unsigned long long>(stats.episodes), static_cast<unsigned long long>(stats.deaths),
+                static_cast<unsigned long long>(stats.cleared));
+    std::printf("%llu snapshot round trips, %llu damaged snapshots still valid, %llu restored games fed\n",
+                static_cast<unsigned long long>(stats.snapshots), static_cast<unsigned long long>(stats.corruptAccepted),
+                static_cast<unsigned long long>(stats.resumedPickups));
+    std::printf("%llu fallback food picks, %llu special foods with no room, %llu mutated level images\n",
+                static_cast<unsigned long long>(stats.fallbackPicks), static_cast<unsigned long long>(stats.specialDenied),
+                static_cast<unsigned long long>(stats.levelImages));
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Builds binary level files (see src/level.h) from text maps, and prints
+// existing ones back as text.
+// Build: g++ -std=c++11 -O2 -Isrc tools/snake_levelmaker.cpp src/level.cpp -o snake_levelmaker
+// Usage: snake_levelmaker MAP.txt LEVEL.lvl
+//        snake_levelmaker -d LEVEL.lvl
+//
+// Map legend, one line per board row (short rows are padded with floor):
+//   #  wall            .  floor (space works too)
+//   ~  floor where food never spawns
+//   > < ^ v  spawn point facing that way (the cell itself is floor)
+//   lines starting with ';' are comments
+#include "level.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static bool buildLevel(const std::string& mapPath, const std::string& outPath) {
+    std::ifstream in(mapPath);
+    if (!in) {
+        std::cerr << "Cannot read " << mapPath << "\n";
+        return false;
+    }
+    std::vector<std::string> rows;
+    std::string line;
+    size_t width = 0;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty() && line[0] == ';') continue;
+        rows.push_back(line);
+        if (line.size() > width) width = line.size();
+    }
+    while (!rows.empty() && rows.back().empty()) rows.pop_back();
+    const size_t height = rows.size();
+    if (width < 2 || height < 2 || width > LEVEL_MAX_SIDE || height > LEVEL_MAX_SIDE) {
+        std::cerr << "Map must be between 2x2 and " << LEVEL_MAX_SIDE << "x" << LEVEL_MAX_SIDE
+                  << " cells, got " << width << "x" << height << "\n";
+        return false;
+    }
+
+    const size_t rowBytes = (width + 7) / 8;
+    std::vector<unsigned char> walls(rowBytes * height, 0);
+    std::vector<unsigned char> exclusion(rowBytes * height, 0);
+    std::vector<LevelSpawn> spawns;
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < rows[y].size(); ++x) {
+            unsigned char bit = static_cast<unsigned char>(1 << (x % 8));
+            size_t byte = y * rowBytes + x / 8;
+            char c = rows[y][x];
+            LevelSpawn spawn = { static_cast<uint8_t>(x), static_cast<uint8_t>(y), 0, 0 };
+            switch (c) {
+                case '#': walls[byte] |= bit; break;
+                case '~': exclusion[byte] |= bit; break;
+                case '^': spawn.direction = UP; spawns.push_back(spawn); break;
+                case 'v': spawn.direction = DOWN; spawns.push_back(spawn); break;
+                case '<': spawn.direction = LEFT; spawns.push_back(spawn); break;
+                case '>': spawn.direction = RIGHT; spawns.push_back(spawn); break;
+                case '.': case ' ': break;
+                default:
+                    std::cerr << mapPath << ": unknown cell '" << c << "' at " << x << "," << y << "\n";
+                    return false;
+            }
+        }
+    }
+    if (spawns.empty()) {
+        std::cerr << mapPath << ": no spawn point (one of > < ^ v)\n";
+        return false;
+    }
+
+    std::vector<unsigned char> payload;
+    payload.insert(payload.end(), walls.begin(), walls.end());
+    payload.insert(payload.end(), exclusion.begin(), exclusion.end());
+    const unsigned char* spawnBytes = reinterpret_cast<const unsigned char*>(spawns.data());
+    payload.insert(payload.end(), spawnBytes, spawnBytes + spawns.size() * sizeof(LevelSpawn));
+
+    LevelFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = LEVEL_MAGIC;
+    header.version = LEVEL_VERSION;
+    header.width = static_cast<uint16_t>(width);
+    header.height = static_cast<uint16_t>(height);
+    header.spawnCount = static_cast<uint16_t>(spawns.size());
+    header.payloadSize = static_cast<uint32_t>(payload.size());
+    header.checksum = levelChecksum(payload.data(), payload.size());
+
+    std::ofstream out(outPath, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(payload.data()), payload.size());
+    if (!out) {
+        std::cerr << "Cannot write " << outPath << "\n";
+        return false;
+    }
+    std::cout << outPath << ": " << width << "x" << height << ", " << spawns.size()
+              << " spawn point(s), checksum " << std::hex << header.checksum << std::dec << "\n";
+    return true;
+}
+
+static bool dumpLevel(const std::string& path) {
+    Level level;
+    if (!level.load(path)) return false;
+    std::vector<std::string> rows(level.getHeight(), std::string(level.getWidth(), '.'));
+    for (int y = 0; y < level.getHeight(); ++y) {
+        for (int x = 0; x < level.getWidth(); ++x) {
+            Position p(x, y);
+            if (level.isWall(p)) rows[y][x] = '#';
+            else if (!level.allowsFood(p)) rows[y][x] = '~';
+        }
+    }
+    static const char arrows[] = { '^', 'v', '<', '>' };
+    for (int i = 0; i < level.getSpawnCount(); ++i) {
+        Position p = level.getSpawn(i);
+        rows[p.y][p.x] = arrows[level.getSpawnDirection(i)];
+    }
+    std::cout << "; " << path << ": " << level.getWidth() << "x" << level.getHeight() << ", "
+              << level.getFreeCells().size() << " food cells, checksum "
+              << std::hex << level.getChecksum() << std::dec << "\n";
+    for (const auto& row : rows) std::cout << row << "\n";
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 3 && std::strcmp(argv[1], "-d") == 0) return dumpLevel(argv[2]) ? 0 : 1;
+    if (argc == 3) return buildLevel(argv[1], argv[2]) ? 0 : 1;
+    std::cerr << "Usage: " << argv[0] << " MAP.txt LEVEL.lvl\n"
+              << "       " << argv[0] << " -d LEVEL.lvl\n";
+    return 2;
+}
@@ -0,0 +1,281 @@
+// Session density load test: runs N games, each on its own pseudo-terminal,
+// drives them with key streams and reports CPU, RSS, context switches and
+// terminal output per instance (Linux, reads /proc).
+// Build: g++ -std=c++11 -O2 tools/snake_loadtest.cpp -o snake_loadtest -lutil
+// Usage: snake_loadtest [-n N] [-t SECONDS] [-r KEYS_PER_SEC] [-s SCRIPT] [-b BINARY] [-- GAME_ARGS...]
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <pty.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct Options {
+    int instances = 8;
+    int seconds = 30;
+    int keysPerSecond = 4;
+    std::string binary = "./snake_game";
+    std::string script; // keys replayed in a loop; random keys when empty
+    std::vector<std::string> gameArgs;
+};
+
+struct ProcSample {
+    double cpuSeconds = 0;
+    long rssKb = 0;
+    long voluntarySwitches = 0;
+    long involuntarySwitches = 0;
+};
+
+struct Instance {
+    pid_t pid = -1;
+    int master = -1;
+    std::string workDir;
+    uint64_t bytesOut = 0;
+    uint64_t keysSent = 0;
+    size_t scriptPos = 0;
+    long peakRssKb = 0;
+    ProcSample last;
+    bool exited = false;
+};
+
+static long clockTicks() {
+    static long ticks = sysconf(_SC_CLK_TCK);
+    return ticks;
+}
+
+static bool sampleProcess(pid_t pid, ProcSample& out) {
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    if (!std::getline(stat, line)) return false;
+    // Fields after the parenthesised command name; utime and stime are fields 14 and 15
+    size_t close = line.rfind(')');
+    if (close == std::string::npos) return false;
+    std::istringstream fields(line.substr(close + 2));
+    std::string field;
+    unsigned long utime = 0, stime = 0;
+    for (int i = 3; i <= 15 && fields >> field; ++i) {
+        if (i == 14) utime = std::stoul(field);
+        if (i == 15) stime = std::stoul(field);
+    }
+    out.cpuSeconds = static_cast<double>(utime + stime) / clockTicks();
+
+    // Nanosecond run time when the kernel has schedstats; an idle game uses
+    // far less than one clock tick
+    std::ifstream schedstat("/proc/" + std::to_string(pid) + "/schedstat");
+    unsigned long long runNs = 0;
+    if (schedstat >> runNs) out.cpuSeconds = runNs / 1e9;
+
+    std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) out.rssKb = std::atol(line.c_str() + 6);
+        else if (line.compare(0, 24, "voluntary_ctxt_switches:") == 0) out.voluntarySwitches = std::atol(line.c_str() + 24);
+        else if (line.compare(0, 27, "nonvoluntary_ctxt_switches:") == 0) out.involuntarySwitches = std::atol(line.c_str() + 27);
+    }
+    return true;
+}
+
+static bool parseOptions(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--") {
+            for (++i; i < argc; ++i) opt.gameArgs.push_back(argv[i]);
+            break;
+        }
+        if (i + 1 >= argc) return false;
+        if (arg == "-n") opt.instances = std::atoi(argv[++i]);
+        else if (arg == "-t") opt.seconds = std::atoi(argv[++i]);
+        else if (arg == "-r") opt.keysPerSecond = std::atoi(argv[++i]);
+        else if (arg == "-b") opt.binary = argv[++i];
+        else if (arg == "-s") {
+            std::ifstream file(argv[++i], std::ios::binary);
+            if (!file) return false;
+            std::ostringstream keys;
+            keys << file.rdbuf();
+            opt.script = keys.str();
+        } else {
+            return false;
+        }
+    }
+    return opt.instances > 0 && opt.seconds > 0 && opt.keysPerSecond > 0;
+}
+
+static bool launch(Instance& inst, const Options& opt, int index) {
+    char dirTemplate[] = "/tmp/snake_loadtest.XXXXXX";
+    if (!mkdtemp(dirTemplate)) return false;
+    inst.workDir = dirTemplate;
+
+    // Absolute path, since every instance runs in its own directory so the
+    // score files don't contend
+    char binaryPath[4096];
+    if (!realpath(opt.binary.c_str(), binaryPath)) return false;
+
+    winsize ws;
+    std::memset(&ws, 0, sizeof(ws));
+    ws.ws_col = 120;
+    ws.ws_row = 40;
+    pid_t pid = forkpty(&inst.master, nullptr, nullptr, &ws);
+    if (pid < 0) return false;
+    if (pid == 0) {
+        if (chdir(inst.workDir.c_str()) != 0) _exit(127);
+        setenv("TERM", "xterm-256color", 1);
+        std::string seed = std::to_string(1000 + index);
+        std::vector<char*> args;
+        args.push_back(binaryPath);
+        args.push_back(const_cast<char*>("--seed"));
+        args.push_back(const_cast<char*>(seed.c_str()));
+        for (const auto& a : opt.gameArgs) args.push_back(const_cast<char*>(a.c_str()));
+        args.push_back(nullptr);
+        execv(binaryPath, args.data());
+        _exit(127);
+    }
+    inst.pid = pid;
+    return true;
+}
+
+// Random play: mostly steering, with an occasional restart sequence that
+// works from any screen (game over -> menu -> new game with a name)
+static std::string randomKeys(std::mt19937& rng) {
+    static const char* steering = "wasd";
+    std::uniform_int_distribution<int> pick(0, 99);
+    int roll = pick(rng);
+    if (roll < 3) return "r1load\n";
+    return std::string(1, steering[roll % 4]);
+}
+
+static void sendKeys(Instance& inst, const Options& opt, std::mt19937& rng) {
+    std::string keys;
+    if (!opt.script.empty()) {
+        keys = opt.script[inst.scriptPos];
+        inst.scriptPos = (inst.scriptPos + 1) % opt.script.size();
+    } else {
+        keys = randomKeys(rng);
+    }
+    if (write(inst.master, keys.data(), keys.size()) > 0) inst.keysSent += keys.size();
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [-n N] [-t SECONDS] [-r KEYS_PER_SEC] [-s SCRIPT] [-b BINARY] [-- GAME_ARGS...]\n";
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<Instance> instances(opt.instances);
+    for (int i = 0; i < opt.instances; ++i) {
+        if (!launch(instances[i], opt, i)) {
+            std::cerr << "Failed to start instance " << i << ": " << std::strerror(errno) << "\n";
+            return 1;
+        }
+        // Without a script every game starts straight away
+        if (opt.script.empty()) {
+            const char start[] = "1load\n";
+            if (write(instances[i].master, start, sizeof(start) - 1) > 0) instances[i].keysSent += sizeof(start) - 1;
+        }
+    }
+
+    typedef std::chrono::steady_clock Clock;
+    const auto start = Clock::now();
+    const auto end = start + std::chrono::seconds(opt.seconds);
+    const auto keyInterval = std::chrono::microseconds(1000000 / opt.keysPerSecond);
+    auto nextKeys = start + keyInterval;
+    auto nextSample = start + std::chrono::seconds(1);
+    std::mt19937 rng(12345);
+    std::vector<pollfd> fds(instances.size());
+    char buffer[65536];
+
+    while (Clock::now() < end) {
+        auto now = Clock::now();
+        auto wake = std::min(std::min(nextKeys, nextSample), end);
+        int timeoutMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(wake - now).count());
+        for (size_t i = 0; i < instances.size(); ++i) {
+            fds[i].fd = instances[i].exited ? -1 : instances[i].master;
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+        poll(fds.data(), fds.size(), timeoutMs > 0 ? timeoutMs : 0);
+
+        // Drain output so no game ever blocks on a full pty
+        for (size_t i = 0; i < instances.size(); ++i) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = read(instances[i].master, buffer, sizeof(buffer));
+            if (n > 0) instances[i].bytesOut += static_cast<uint64_t>(n);
+            else instances[i].exited = true;
+        }
+
+        now = Clock::now();
+        if (now >= nextKeys) {
+            for (auto& inst : instances) {
+                if (!inst.exited) sendKeys(inst, opt, rng);
+            }
+            nextKeys += keyInterval;
+        }
+        if (now >= nextSample) {
+            for (auto& inst : instances) {
+                if (!inst.exited && sampleProcess(inst.pid, inst.last) && inst.last.rssKb > inst.peakRssKb) {
+                    inst.peakRssKb = inst.last.rssKb;
+                }
+            }
+            nextSample += std::chrono::seconds(1);
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Final sample while the processes are still alive
+    for (auto& inst : instances) {
+        if (!inst.exited && sampleProcess(inst.pid, inst.last) && inst.last.rssKb > inst.peakRssKb) {
+            inst.peakRssKb = inst.last.rssKb;
+        }
+    }
+
+    double totalCpu = 0;
+    long totalSwitches = 0;
+    long totalPeakRss = 0;
+    uint64_t totalBytes = 0;
+    int exited = 0;
+    std::printf("%4s %8s %9s %8s %10s %10s %12s %8s\n",
+                "inst", "cpu_s", "cpu_%", "rss_kb", "vol_cs", "invol_cs", "bytes_out", "keys");
+    for (size_t i = 0; i < instances.size(); ++i) {
+        const Instance& inst = instances[i];
+        std::printf("%4zu %8.4f %9.3f %8ld %10ld %10ld %12llu %8llu%s\n",
+                    i, inst.last.cpuSeconds, 100.0 * inst.last.cpuSeconds / elapsed, inst.peakRssKb,
+                    inst.last.voluntarySwitches, inst.last.involuntarySwitches,
+                    static_cast<unsigned long long>(inst.bytesOut),
+                    static_cast<unsigned long long>(inst.keysSent), inst.exited ? "  (exited)" : "");
+        totalCpu += inst.last.cpuSeconds;
+        totalSwitches += inst.last.voluntarySwitches + inst.last.involuntarySwitches;
+        totalPeakRss += inst.peakRssKb;
+        totalBytes += inst.bytesOut;
+        if (inst.exited) exited++;
+    }
+
+    double n = static_cast<double>(instances.size());
+    std::printf("\ninstances: %zu over %.1f s (%d exited early)\n", instances.size(), elapsed, exited);
+    std::printf("aggregate cpu: %.4f s (%.3f%% of one core)\n", totalCpu, 100.0 * totalCpu / elapsed);
+    std::printf("per instance: cpu %.4f%%, rss %.0f kB, %.1f context switches/s, %.0f bytes/s\n",
+                100.0 * totalCpu / elapsed / n, totalPeakRss / n, totalSwitches / elapsed / n, totalBytes / elapsed / n);
+    if (totalCpu > 0) std::printf("sessions per core: %.0f\n", n * elapsed / totalCpu);
+
+    for (auto& inst : instances) {
+        kill(inst.pid, SIGTERM);
+        waitpid(inst.pid, nullptr, 0);
+        close(inst.master);
+        // The game only ever writes its score files here
+        unlink((inst.workDir + "/highscore.txt").c_str());
+        unlink((inst.workDir + "/scores.txt").c_str());
+        if (rmdir(inst.workDir.c_str()) != 0) std::cerr << "Could not remove " << inst.workDir << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Prints the live metrics of a running game started with --metrics NAME.
+// Build: g++ -std=c++11 -O2 -Isrc tools/snake_metrics.cpp -o snake_metrics
+// Usage: snake_metrics NAME [interval_ms]
+#include "metrics.h"
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Seqlock reader: copies the block until no update overlapped the copy
+static bool readBlock(const MetricsBlock* shared, RuntimeCounters& out, uint64_t& publishTimeNs) {
+    for (int attempt = 0; attempt < 1000; ++attempt) {
+        uint32_t s1 = shared->sequence.load(std::memory_order_acquire);
+        if (s1 & 1) continue;
+        out.state = shared->state;
+        out.ticks = shared->ticks;
+        out.framesRendered = shared->framesRendered;
+        out.bytesWritten = shared->bytesWritten;
+        out.inputEvents = shared->inputEvents;
+        out.foodSpawnAttempts = shared->foodSpawnAttempts;
+        out.fps = shared->fps;
+        publishTimeNs = shared->publishTimeNs;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (shared->sequence.load(std::memory_order_relaxed) == s1) return true;
+    }
+    return false;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " SHM_NAME [interval_ms]\n";
+        return 2;
+    }
+    int intervalMs = argc > 2 ? std::atoi(argv[2]) : 0;
+
+    int fd = shm_open(argv[1], O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "Cannot open " << argv[1] << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+    void* mem = mmap(nullptr, sizeof(MetricsBlock), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) return 1;
+    const MetricsBlock* shared = static_cast<const MetricsBlock*>(mem);
+    if (shared->magic != METRICS_MAGIC || shared->version != METRICS_VERSION) {
+        std::cerr << "Unexpected metrics layout (version " << shared->version << ")\n";
+        return 1;
+    }
+
+    do {
+        RuntimeCounters c;
+        uint64_t publishTimeNs = 0;
+        if (!readBlock(shared, c, publishTimeNs)) {
+            std::cerr << "Metrics block kept changing, giving up\n";
+            return 1;
+        }
+        std::cout << "pid=" << shared->pid << " state=" << c.state << " ticks=" << c.ticks
+                  << " frames=" << c.framesRendered << " bytes=" << c.bytesWritten
+                  << " input=" << c.inputEvents << " food_attempts=" << c.foodSpawnAttempts
+                  << " fps=" << c.fps << " published_ns=" << publishTimeNs << std::endl;
+        if (intervalMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    } while (intervalMs > 0);
+
+    munmap(mem, sizeof(MetricsBlock));
+    return 0;
+}